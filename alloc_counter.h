@@ -0,0 +1,32 @@
+#pragma once
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Счётчик выделений памяти через глобальный operator new.
+// Замена operator new должна определяться ровно в одной единице трансляции:
+// для этого перед включением файла задаётся PARAPLAN_COUNT_ALLOCATIONS.
+// Без неё count() всегда возвращает 0.
+namespace AllocCounter {
+    inline std::atomic<unsigned long long> allocations{ 0 };
+
+    inline unsigned long long count() {
+        return allocations.load(std::memory_order_relaxed);
+    }
+}
+
+#ifdef PARAPLAN_COUNT_ALLOCATIONS
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC не знает, что operator new заменён парным malloc, и предупреждает о free в delete
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    AllocCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
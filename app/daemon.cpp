@@ -0,0 +1,116 @@
+#include "solver_service.h"
+#include <iostream>
+#include <string>
+#include <mutex>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstring>
+#endif
+
+// Использование: paraplan_daemon [--socket путь]
+// Без --socket запросы читаются построчно со стандартного ввода, ответы идут в стандартный вывод.
+// С --socket сервис слушает сокет Unix и обслуживает клиентов по очереди; экземпляры,
+// пулы потоков и фронты остаются в памяти между подключениями. События прогона,
+// завершившегося после отключения клиента, отбрасываются, фронт забирается запросом front.
+// Протокол описан в solver_service.h.
+#ifndef _WIN32
+static int serveSocket(const std::string& path) {
+    std::signal(SIGPIPE, SIG_IGN);
+    int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (server < 0 || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Не удалось создать сокет " << path << "\n";
+        return 1;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    ::unlink(path.c_str());
+    if (::bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(server, 4) != 0) {
+        std::cerr << "Не удалось открыть сокет " << path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    std::mutex client_mutex;
+    int client = -1;
+    SolverService service([&](const std::string& line) {
+        std::lock_guard<std::mutex> lock(client_mutex);
+        if (client < 0) return;
+        std::string out = line + '\n';
+        for (size_t sent = 0; sent < out.size();) {
+            ssize_t n = ::send(client, out.data() + sent, out.size() - sent, 0);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+    });
+
+    bool running = true;
+    while (running) {
+        int fd = ::accept(server, nullptr, nullptr);
+        if (fd < 0) continue;
+        {
+            std::lock_guard<std::mutex> lock(client_mutex);
+            client = fd;
+        }
+        std::string buffer;
+        char chunk[4096];
+        while (running) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) break;
+            buffer.append(chunk, static_cast<size_t>(n));
+            size_t start = 0, end;
+            while (running && (end = buffer.find('\n', start)) != std::string::npos) {
+                std::string line = buffer.substr(start, end - start);
+                start = end + 1;
+                if (!line.empty()) running = service.handle(line);
+            }
+            buffer.erase(0, start);
+            // Клиент, не присылающий перевода строки, не может раздуть буфер без предела
+            if (buffer.size() > Config::SERVICE_MAX_LINE) {
+                service.reject("строка запроса длиннее " + std::to_string(Config::SERVICE_MAX_LINE) + " байт, соединение закрыто");
+                break;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(client_mutex);
+            client = -1;
+        }
+        ::close(fd);
+    }
+    service.shutdown();
+    ::close(server);
+    ::unlink(path.c_str());
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+    std::string socket_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) socket_path = argv[++i];
+    }
+#ifndef _WIN32
+    if (!socket_path.empty()) return serveSocket(socket_path);
+#else
+    if (!socket_path.empty()) {
+        std::cerr << "--socket поддерживается только на POSIX\n";
+        return 1;
+    }
+#endif
+
+    SolverService service([](const std::string& line) { std::cout << line << std::endl; });
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line.empty()) continue;
+        if (!service.handle(line)) {
+            service.shutdown();
+            return 0;
+        }
+    }
+    // Конец ввода: дождаться начатых прогонов, чтобы их результаты попали в вывод
+    service.wait();
+    return 0;
+}
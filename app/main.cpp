@@ -1,36 +1,182 @@
 #include "genetic_algorithm.h"
+#include "decomposition.h"
+#include "island_model.h"
+#include "scenario.h"
+#include "exporters.h"
+#include <filesystem>
 #include <iostream>
-void printSchedule(const Schedule& s, int index) {
-    auto fitness = s.calculateFitness();
-    std::cout << "\n=== Расписание " << index + 1 << " (Конфликты = " << fitness[0]
-        << ", Окна = " << fitness[1] << ", Баланс = " << fitness[2] << ") ===\n";
-    for (int g = 0; g < Config::NUM_GROUPS; ++g) {
-        std::cout << "\nГруппа: " << Config::groups[g] << "\n";
-        for (int d = 0; d < Config::NUM_DAYS; ++d) {
-            std::cout << "  " << Config::days[d] << ":\n";
-            std::vector<Lesson> day_lessons;
-            for (auto& l : s.lessons)
-                if (l.group == g && l.day == d)
-                    day_lessons.push_back(l);
-            std::sort(day_lessons.begin(), day_lessons.end(),
-                [](const Lesson& a, const Lesson& b) { return a.slot < b.slot; });
+#include <string>
+#include <cstdlib>
+// Использование: paraplan [файл задачи] [--trace трасса.jsonl] [--quiet] [--time секунды]
+//                 [--checkpoint снимок.bin] [--resume снимок.bin] [--seed снимок.bin] [--parts K]
+//                 [--scenarios сценарии.json] [--export каталог] [--start ГГГГ-ММ-ДД]
+//                 [--islands K [--topology ring|full]]
+// С --time поиск идёт до срока или до застоя, без него — как GeneticAlgorithm::run.
+// --checkpoint периодически сохраняет состояние, --resume продолжает с него,
+// --seed берёт архив снимка (например, прошлого семестра) в начальную популяцию.
+// --parts делит задачу на K независимых частей и возвращает одно объединённое расписание;
+// не сочетается с --checkpoint, --resume, --seed и --trace.
+// --islands решает задачу островной моделью (island_model.h): K популяций с миграцией
+// по кольцу или между всеми; 0 — по числу ядер. Не сочетается с --time, --parts,
+// --checkpoint, --resume, --seed и --trace.
+// --scenarios решает базу и сценарии «что если» из файла (scenario.h) и печатает сравнительную таблицу.
+// --export записывает фронт в каталог: front.csv, front.json и календари лучшего по свёртке
+// расписания в calendars/ с первым днём недели --start; при поиске с --time front.json
+// обновляется по ходу прогона.
+int main(int argc, char** argv) {
+    std::string instance_path;
+    std::string trace_path;
+    bool quiet = false;
+    double time_limit = 0.0;
+    std::string checkpoint_path, resume_path, seed_path;
+    int parts = 1;
+    std::string scenarios_path;
+    std::string export_dir;
+    std::string start_date = Config::SEMESTER_START;
+    int islands = -1;
+    std::string topology;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) trace_path = argv[++i];
+        else if (arg == "--quiet") quiet = true;
+        else if (arg == "--time" && i + 1 < argc) time_limit = std::atof(argv[++i]);
+        else if (arg == "--checkpoint" && i + 1 < argc) checkpoint_path = argv[++i];
+        else if (arg == "--resume" && i + 1 < argc) resume_path = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed_path = argv[++i];
+        else if (arg == "--parts" && i + 1 < argc) parts = std::atoi(argv[++i]);
+        else if (arg == "--scenarios" && i + 1 < argc) scenarios_path = argv[++i];
+        else if (arg == "--export" && i + 1 < argc) export_dir = argv[++i];
+        else if (arg == "--start" && i + 1 < argc) start_date = argv[++i];
+        else if (arg == "--islands" && i + 1 < argc) islands = std::atoi(argv[++i]);
+        else if (arg == "--topology" && i + 1 < argc) topology = argv[++i];
+        else instance_path = arg;
+    }
 
-            for (auto& l : day_lessons) {
-                std::cout << "    Лента " << l.slot + 1 << ": "
-                    << Config::subjects[l.subject] << " ведет "
-                    << Config::teachers[l.teacher] << " в аудитории "
-                    << Config::rooms[l.room] << " (" << l.type << ")\n";
-            }
+    // Без файла задачи используются тестовые данные
+    Instance instance;
+    try {
+        instance = instance_path.empty() ? Instance::fromConfig() : Instance::load(instance_path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    if (!scenarios_path.empty()) {
+        SolveOptions options;
+        options.time_limit = time_limit;
+        if (time_limit > 0) options.max_generations = 0;
+        try {
+            BatchSolver batch(instance, Scenario::load(scenarios_path, instance), std::random_device{}());
+            BatchSolver::printReport(std::cout, batch.solve(options));
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
         }
+        return 0;
+    }
+
+    if (islands >= 0 && (time_limit > 0 || parts > 1 || !checkpoint_path.empty() || !resume_path.empty() ||
+        !seed_path.empty() || !trace_path.empty())) {
+        std::cerr << "--islands не сочетается с --time, --parts, --checkpoint, --resume, --seed и --trace\n";
+        return 1;
+    }
+    // Части решаются своими GeneticAlgorithm, а снимок и трасса относятся к одному прогону всей задачи
+    if (parts > 1 && (!checkpoint_path.empty() || !resume_path.empty() || !seed_path.empty() || !trace_path.empty())) {
+        std::cerr << "--parts не сочетается с --checkpoint, --resume, --seed и --trace\n";
+        return 1;
+    }
+    if (islands < 0 && !topology.empty()) {
+        std::cerr << "--topology задаётся только вместе с --islands\n";
+        return 1;
+    }
+
+    Export::Date start;
+    MigrationTopology migration = MigrationTopology::Ring;
+    try {
+        start = Export::Date::parse(start_date);
+        if (!topology.empty()) migration = IslandModel::parseTopology(topology);
+        if (!export_dir.empty()) std::filesystem::create_directories(export_dir);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    GeneticAlgorithm ga(instance, std::random_device{}());
+    ga.setConsoleOutput(!quiet);
+    try {
+        ga.setTrace(trace_path);
+        if (!seed_path.empty()) ga.seed(Checkpoint::seedSchedules(seed_path, instance));
+        if (!resume_path.empty()) ga.loadCheckpoint(resume_path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
     }
-}
 
-int main() {
-    GeneticAlgorithm ga;
-    std::vector<Schedule> pareto_front = ga.run();
+    std::vector<Schedule> pareto_front;
+    if (islands >= 0) {
+        IslandModel model(instance, std::random_device{}(), static_cast<size_t>(islands), migration);
+        std::cout << "Островов: " << model.size() << '\n';
+        pareto_front = model.run();
+    }
+    else if (parts > 1) {
+        SolveOptions options;
+        options.time_limit = time_limit;
+        if (time_limit > 0) options.max_generations = 0;
+        DecomposedSolver solver(instance, parts, std::random_device{}());
+        std::cout << "Частей: " << solver.size() << '\n';
+        pareto_front.push_back(solver.solve(options));
+    }
+    else if (time_limit > 0 || !checkpoint_path.empty() || !resume_path.empty()) {
+        SolveOptions options;
+        options.time_limit = time_limit;
+        if (time_limit > 0) options.max_generations = 0;
+        options.resume = !resume_path.empty();
+        options.checkpoint_path = checkpoint_path;
+        std::function<void(const SolveProgress&)> stream;
+        if (!export_dir.empty()) stream = Export::streamArchive(export_dir + "/front.json");
+        if (!quiet || stream) {
+            options.progress_interval = 10;
+            options.on_progress = [quiet, stream](const SolveProgress& p) {
+                if (!quiet) {
+                    std::cout << "Generation " << p.generation << " (" << p.seconds << " s): archive size = "
+                        << p.front.size() << ", best conflicts = " << p.stats.best[0] << '\n';
+                }
+                if (stream) stream(p);
+            };
+        }
+        SolveResult result = ga.solve(options);
+        std::cout << "Остановка: " << stopReasonName(result.reason) << ", поколений " << result.generations
+            << ", оценок " << result.evaluations << ", " << result.seconds << " с\n";
+        pareto_front = std::move(result.front);
+    }
+    else {
+        pareto_front = ga.run();
+    }
     std::cout << "\n=== Найдено " << pareto_front.size() << " Парето-оптимальных расписаний ===\n";
-    for (size_t i = 0; i < pareto_front.size(); ++i) {
-        printSchedule(pareto_front[i], i);
+    std::cout.flush();
+    try {
+        Export::BufferedWriter out(stdout);
+        for (size_t i = 0; i < pareto_front.size(); ++i) Export::writeText(out, pareto_front[i], i);
+        out.close();
+
+        if (!export_dir.empty() && !pareto_front.empty()) {
+            Export::replaceFile(export_dir + "/front.csv", [&](Export::BufferedWriter& w) { Export::writeCsv(w, pareto_front); });
+            Export::replaceFile(export_dir + "/front.json", [&](Export::BufferedWriter& w) { Export::writeJson(w, pareto_front); });
+            size_t best = 0;
+            for (size_t i = 1; i < pareto_front.size(); ++i) {
+                if (Schedule::weightedFitness(pareto_front[i].fitness()) < Schedule::weightedFitness(pareto_front[best].fitness())) best = i;
+            }
+            std::filesystem::create_directories(export_dir + "/calendars");
+            Export::writeCalendars(export_dir + "/calendars", pareto_front[best], start);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
     }
     return 0;
 }
@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <cstdio>
+#include <stdexcept>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Атомарная замена файла: содержимое пишется во временный файл рядом с
+// целевым, сбрасывается на диск и переименовывается поверх цели. Читатель
+// видит либо прежний файл, либо новый целиком; при сбое питания после
+// замены на диске не остаётся пустого или недописанного файла.
+namespace AtomicFile {
+
+// Временный файл для path: в том же каталоге, чтобы rename не пересекал файловые системы
+inline std::string tempPath(const std::string& path) { return path + ".tmp"; }
+
+// Данные tmp на диск; поток, которым он писался, уже должен быть закрыт
+inline void sync(const std::string& tmp) {
+#ifdef _WIN32
+    int fd = _open(tmp.c_str(), _O_RDWR | _O_BINARY);
+    bool ok = fd >= 0 && _commit(fd) == 0;
+    if (fd >= 0) _close(fd);
+#else
+    int fd = ::open(tmp.c_str(), O_RDONLY);
+    bool ok = fd >= 0 && ::fsync(fd) == 0;
+    if (fd >= 0) ::close(fd);
+#endif
+    if (!ok) throw std::runtime_error("не удалось сбросить на диск файл: " + tmp);
+}
+
+// Сбросить tmp на диск и заменить им path. rename в POSIX заменяет цель
+// атомарно, поэтому прежний файл не удаляется заранее: между удалением и
+// переименованием путь остался бы пустым. На Windows то же делает MoveFileEx.
+inline void replace(const std::string& tmp, const std::string& path) {
+    sync(tmp);
+#ifdef _WIN32
+    bool ok = MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+    if (ok) {
+        // Запись каталога, чтобы на диске осталось и само переименование; сбой здесь не теряет данных
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+#endif
+    if (!ok) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("не удалось заменить файл: " + path);
+    }
+}
+
+} // namespace AtomicFile
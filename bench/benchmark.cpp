@@ -0,0 +1,332 @@
+// Бенчмарк планировщика на синтетических экземплярах.
+// Сборка: g++ -std=c++17 -O2 -pthread -I. bench/benchmark.cpp -o paraplan_bench
+// Запуск:  ./paraplan_bench [число групп ...] (по умолчанию 10 100 1000 5000)
+#define PARAPLAN_COUNT_ALLOCATIONS
+#include "alloc_counter.h"
+#include "genetic_algorithm.h"
+#include "incremental_evaluator.h"
+#include "instance_generator.h"
+#include "rescheduler.h"
+#include "island_model.h"
+#include "exporters.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <iterator>
+#include <limits>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const unsigned SEED = 12345;
+    const double EVAL_BUDGET_SEC = 0.5;   // Время на замер скорости оценки
+    const double GA_BUDGET_SEC = 3.0;     // Время на прогон GA для одного размера
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Полных оценок calculateFitness в секунду
+    double benchFullEvaluation(const Instance& inst) {
+        std::mt19937 gen(SEED);
+        Schedule s(inst);
+        s.initialize(gen);
+        long long evals = 0;
+        double checksum = 0.0;
+        auto start = Clock::now();
+        do {
+            for (int i = 0; i < 8; ++i, ++evals) checksum += s.calculateFitness()[0];
+        } while (secondsSince(start) < EVAL_BUDGET_SEC);
+        if (checksum < 0) std::printf(" ");
+        return evals / secondsSince(start);
+    }
+
+    // Оценок переноса одного занятия (IncrementalEvaluator::moveDelta) в секунду
+    double benchMoveDelta(const Instance& inst) {
+        std::mt19937 gen(SEED);
+        Schedule s(inst);
+        s.initialize(gen);
+        IncrementalEvaluator eval(s);
+        std::uniform_int_distribution<> pick(0, static_cast<int>(s.lessons.size()) - 1);
+        std::vector<Lesson> moves;
+        std::vector<size_t> indexes;
+        for (int i = 0; i < 4096; ++i) {
+            size_t idx = pick(gen);
+            indexes.push_back(idx);
+            moves.push_back(s.mutatedLesson(s.lessons[idx], eval.teacherLoads(), gen));
+        }
+        long long evals = 0;
+        double checksum = 0.0;
+        auto start = Clock::now();
+        do {
+            for (size_t i = 0; i < moves.size(); ++i, ++evals) checksum += eval.moveDelta(indexes[i], moves[i])[0];
+        } while (secondsSince(start) < EVAL_BUDGET_SEC);
+        if (checksum > 1e300) std::printf(" ");
+        return evals / secondsSince(start);
+    }
+
+    // Штрафы занятий (FitnessKernel): скалярный и векторный варианты, нс на занятие
+    void benchLessonKernel(const std::vector<int>& sizes) {
+        std::printf("\nFitnessKernel, нс/занятие (AVX2 %s)\n%8s %10s %10s\n", FitnessKernel::simdAvailable(Instance::defaultInstance()) ? "есть" : "нет",
+            "групп", "скаляр", "AVX2");
+        for (int groups : sizes) {
+            Instance inst = generateInstance(groups, SEED);
+            std::mt19937 gen(SEED);
+            Schedule s(inst);
+            s.initialize(gen);
+            auto measure = [&](auto kernel) {
+                long long calls = 0, checksum = 0;
+                auto start = Clock::now();
+                do {
+                    for (int i = 0; i < 8; ++i, ++calls) checksum += kernel(inst, s.lessons.data(), s.lessons.size()).type;
+                } while (secondsSince(start) < EVAL_BUDGET_SEC);
+                if (checksum < 0) std::printf(" ");
+                return secondsSince(start) * 1e9 / (static_cast<double>(calls) * s.lessons.size());
+            };
+            double scalar = measure(FitnessKernel::countScalar);
+#ifdef PARAPLAN_AVX2_KERNEL
+            double simd = FitnessKernel::simdAvailable(inst) ? measure(FitnessKernel::countAvx2) : -1.0;
+#else
+            double simd = -1.0;
+#endif
+            std::printf("%8d %10.2f %10.2f\n", groups, scalar, simd);
+        }
+    }
+
+    // Время сортировки по недоминированию для популяций разного размера
+    void benchSort(const Instance& inst) {
+        std::printf("\nnonDominatedSort (%d групп)\n%10s %12s %8s\n", inst.num_groups, "N", "мс", "фронтов");
+        std::mt19937 gen(SEED);
+        for (size_t n : { 50, 200, 1000, 5000 }) {
+            std::vector<Schedule::Fitness> objectives(n);
+            for (auto& f : objectives) {
+                Schedule s(inst);
+                s.initialize(gen);
+                s.mutate(gen);
+                f = s.fitness();
+            }
+            NonDominatedSorter sorter;
+            std::vector<int> rank;
+            std::vector<double> crowding;
+            sorter.sort(objectives, rank, crowding); // прогрев буферов
+            int repeats = 0;
+            auto start = Clock::now();
+            do {
+                sorter.sort(objectives, rank, crowding);
+                ++repeats;
+            } while (secondsSince(start) < 0.2);
+            std::printf("%10zu %12.3f %8zu\n", n, secondsSince(start) * 1000.0 / repeats, sorter.frontCount());
+        }
+    }
+
+    // Схемы отбора выживших при одинаковом бюджете оценок: лучшая свёртка целей в архиве
+    // на половине и в конце бюджета и сколько оценок нужно, чтобы достичь итога поколенческой схемы
+    void benchSurvival(int groups) {
+        const long long budget = 6000;
+        const unsigned seeds[] = { SEED, SEED + 1, SEED + 2 };
+        const Survival schemes[] = { Survival::Generational, Survival::MuPlusLambda, Survival::SteadyState };
+        Instance inst = generateInstance(groups, SEED);
+        std::printf("\nОтбор выживших (%d групп, %lld оценок, среднее по %zu зёрнам)\n%14s %14s %14s %16s\n", groups, budget,
+            std::size(seeds), "схема", "свёртка 1/2", "свёртка", "оценок до итога");
+
+        // Ход прогона: (оценок, лучшая свёртка в архиве) после каждого поколения
+        using Trace = std::vector<std::pair<long long, double>>;
+        std::vector<std::vector<Trace>> traces(std::size(schemes));
+        for (size_t k = 0; k < std::size(schemes); ++k) {
+            for (unsigned seed : seeds) {
+                GeneticAlgorithm ga(inst, seed);
+                ga.setSurvival(schemes[k]);
+                Trace trace;
+                SolveOptions options;
+                options.max_generations = 0;
+                options.stall_window = 0;
+                options.max_evaluations = budget;
+                options.on_progress = [&](const SolveProgress& p) {
+                    double best = 1e300;
+                    for (size_t i = 0; i < p.front.size(); ++i) best = std::min(best, Schedule::weightedFitness(p.front.objectives(i)));
+                    trace.emplace_back(p.evaluations, best);
+                };
+                ga.solve(options);
+                traces[k].push_back(std::move(trace));
+            }
+        }
+
+        auto at = [](const Trace& t, long long evaluations) {
+            double value = t.front().second;
+            for (const auto& point : t) if (point.first <= evaluations) value = point.second;
+            return value;
+        };
+        double target = 0.0;
+        for (const Trace& t : traces[0]) target += t.back().second / std::size(seeds);
+
+        for (size_t k = 0; k < std::size(schemes); ++k) {
+            double half = 0.0, final = 0.0, to_target = 0.0;
+            for (const Trace& t : traces[k]) {
+                half += at(t, budget / 2) / std::size(seeds);
+                final += t.back().second / std::size(seeds);
+                long long reached = budget;
+                for (const auto& point : t) if (point.second <= target) { reached = point.first; break; }
+                to_target += static_cast<double>(reached) / std::size(seeds);
+            }
+            std::printf("%14s %14.6f %14.6f %16.0f\n", survivalName(schemes[k]), half, final, to_target);
+            std::fflush(stdout);
+        }
+    }
+
+    // Перепланирование после болезни преподавателя (два дня), закрытия аудитории и нового занятия.
+    // Исходное расписание — жадное с ремонтом, как лучшие особи начальной популяции.
+    void benchReschedule(const std::vector<int>& sizes) {
+        std::printf("\nRescheduler\n%8s %8s %12s %12s %10s\n", "групп", "занятий", "мс", "изменено", "нарушений");
+        for (int groups : sizes) {
+            Instance inst = generateInstance(groups, SEED);
+            std::mt19937 gen(SEED);
+            Schedule s(inst);
+            GreedyInitializer().initialize(s, gen);
+            Repairer().repair(s, gen);
+
+            Disruption disruption;
+            disruption.teacherUnavailable(s.lessons[0].teacher, 0b11);
+            disruption.closeRoom(s.lessons[1].room);
+            disruption.addLesson(0, s.lessons[0].teacher, s.lessons[0].subject, LessonType::Practice);
+
+            Rescheduler rescheduler;
+            RescheduleResult result = rescheduler.reschedule(s, disruption, gen);
+            std::printf("%8d %8zu %12.3f %12zu %10lld\n", groups, result.schedule.lessons.size(), result.seconds * 1000.0,
+                result.changed.size(), result.violations);
+        }
+    }
+
+    // Выгрузка одного расписания в текст, CSV и JSON: миллисекунды на формат
+    void benchExport(const std::vector<int>& sizes) {
+        std::printf("\nВыгрузка расписания, мс\n%8s %8s %10s %10s %10s %10s\n", "групп", "занятий", "текст", "CSV", "JSON", "МБ JSON");
+        for (int groups : sizes) {
+            Instance inst = generateInstance(groups, SEED);
+            std::mt19937 gen(SEED);
+            std::vector<Schedule> front(1, Schedule(inst));
+            GreedyInitializer().initialize(front[0], gen);
+            front[0].fitness();
+
+            auto measure = [](auto write) {
+                std::FILE* file = std::tmpfile();
+                auto start = Clock::now();
+                {
+                    Export::BufferedWriter out(file);
+                    write(out);
+                    out.close();
+                }
+                double ms = secondsSince(start) * 1000.0;
+                long bytes = std::ftell(file);
+                std::fclose(file);
+                return std::make_pair(ms, bytes);
+            };
+            auto text = measure([&](Export::BufferedWriter& out) { Export::writeText(out, front[0], 0); });
+            auto csv = measure([&](Export::BufferedWriter& out) { Export::writeCsv(out, front); });
+            auto json = measure([&](Export::BufferedWriter& out) { Export::writeJson(out, front); });
+            std::printf("%8d %8zu %10.2f %10.2f %10.2f %10.2f\n", groups, front[0].lessons.size(), text.first, csv.first, json.first,
+                json.second / 1048576.0);
+        }
+    }
+
+    // Островная модель: фиксированное число поколений на остров без остановки по отсутствию
+    // накладок, разное число островов и топологии
+    void benchIslands(int groups, int generations) {
+        std::printf("\nIslandModel (%d групп, %d поколений)\n%8s %10s %10s %8s %12s %12s\n", groups, generations,
+            "островов", "топология", "с", "фронт", "накладки", "свёртка");
+        Instance inst = generateInstance(groups, SEED);
+        for (size_t islands : { 1, 2, 4 }) {
+            for (MigrationTopology topology : { MigrationTopology::Ring, MigrationTopology::FullyConnected }) {
+                if (islands == 1 && topology == MigrationTopology::FullyConnected) continue;
+                auto start = Clock::now();
+                IslandModel model(inst, SEED, islands, topology);
+                std::vector<Schedule> front = model.run(generations, false);
+                double seconds = secondsSince(start);
+                double conflicts = std::numeric_limits<double>::infinity();
+                double weighted = std::numeric_limits<double>::infinity();
+                for (const Schedule& s : front) {
+                    conflicts = std::min(conflicts, s.fitness()[0]);
+                    weighted = std::min(weighted, Schedule::weightedFitness(s.fitness()));
+                }
+                std::printf("%8zu %10s %10.2f %8zu %12.6f %12.6f\n", islands, topology == MigrationTopology::Ring ? "ring" : "full",
+                    seconds, front.size(), conflicts, weighted);
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    struct GaResult {
+        double generations_per_sec = 0.0;
+        double allocs_per_generation = 0.0;
+        double time_to_conflict_free = -1.0; // -1 — не достигнуто за отведённое время
+        int generations = 0;
+    };
+
+    bool hasZeroConflicts(const GeneticAlgorithm& ga) {
+        for (size_t i = 0; i < ga.populationSize(); ++i)
+            if (ga.objectives(i)[0] == 0.0) return true;
+        return false;
+    }
+
+    GaResult benchGa(const Instance& inst) {
+        GaResult result;
+        auto start = Clock::now();
+        GeneticAlgorithm ga(inst, SEED);
+        ga.reset();
+        if (hasZeroConflicts(ga)) result.time_to_conflict_free = secondsSince(start);
+
+        // Первые поколения заполняют буферы, выделения считаются после них
+        const int warmup = 2;
+        unsigned long long allocs_before = 0;
+        auto gen_start = Clock::now();
+        while (secondsSince(start) < GA_BUDGET_SEC && result.generations < Config::MAX_GENERATIONS) {
+            if (result.generations == warmup) {
+                allocs_before = AllocCounter::count();
+                gen_start = Clock::now();
+            }
+            ga.evolve();
+            ++result.generations;
+            if (result.time_to_conflict_free < 0 && hasZeroConflicts(ga)) {
+                result.time_to_conflict_free = secondsSince(start);
+            }
+        }
+        int measured = result.generations - warmup;
+        if (measured > 0) {
+            result.generations_per_sec = measured / secondsSince(gen_start);
+            result.allocs_per_generation = static_cast<double>(AllocCounter::count() - allocs_before) / measured;
+        }
+        else {
+            // На больших экземплярах за бюджет успевает пройти меньше поколений, чем прогрев
+            result.generations_per_sec = result.generations / secondsSince(start);
+            result.allocs_per_generation = -1.0;
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = { 10, 100, 1000, 5000 };
+
+    std::printf("%8s %8s %14s %14s %10s %12s %10s %12s\n", "групп", "занятий", "оценок/с", "ходов/с",
+        "поколений", "поколений/с", "выдел./пок", "без конфл., с");
+    for (int groups : sizes) {
+        Instance inst = generateInstance(groups, SEED);
+        double full = benchFullEvaluation(inst);
+        double delta = benchMoveDelta(inst);
+        GaResult ga = benchGa(inst);
+        char conflict_free[32] = "-";
+        if (ga.time_to_conflict_free >= 0) std::snprintf(conflict_free, sizeof(conflict_free), "%.3f", ga.time_to_conflict_free);
+        std::printf("%8d %8d %14.0f %14.0f %10d %12.2f %10.1f %12s\n", groups, inst.lessonsPerSchedule(), full, delta,
+            ga.generations, ga.generations_per_sec, ga.allocs_per_generation, conflict_free);
+        std::fflush(stdout);
+    }
+
+    benchSort(generateInstance(sizes.front(), SEED));
+    benchLessonKernel(sizes);
+    benchSurvival(50);
+    benchIslands(100, 50);
+    benchReschedule(sizes);
+    benchExport(sizes);
+    return 0;
+}
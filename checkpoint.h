@@ -0,0 +1,282 @@
+#pragma once
+#include "schedule.h"
+#include "instance.h"
+#include "atomic_file.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Двоичный снимок состояния GeneticAlgorithm.
+// Файл — заголовок и блоки POD-данных, каждый с границы 8 байт:
+//   гены популяции      population * genes * sizeof(Lesson)
+//   цели популяции      population * Fitness
+//   гены архива         archive * genes * sizeof(Lesson)
+//   цели архива         archive * Fitness
+//   состояния ГСЧ       rng_bytes (текстовое представление std::mt19937)
+// При чтении файл отображается в память, а гены копируются в расписания
+// блоком, без разбора. Снимок привязан к экземпляру задачи через хэш его
+// размеров и таблиц; снимок другого экземпляра по умолчанию отвергается.
+namespace Checkpoint {
+
+constexpr char MAGIC[8] = { 'P', 'P', 'L', 'N', 'S', 'N', 'A', 'P' };
+constexpr uint32_t VERSION = 1;
+// Текст состояния std::mt19937 — не меньше 624 чисел, каждое с разделителем
+constexpr uint64_t MIN_RNG_TEXT = 624 * 2;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t lesson_size;       // sizeof(Lesson) при записи
+    uint64_t instance_hash;
+    uint32_t genes;             // Занятий в расписании
+    uint32_t population;
+    uint32_t archive;
+    uint32_t rng_count;         // Главный ГСЧ и ГСЧ частей популяции
+    int64_t generation;
+    int64_t evaluations;
+    uint64_t rng_bytes;
+};
+
+static_assert(std::is_trivially_copyable<Header>::value, "Header пишется через memcpy");
+
+inline size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+// FNV-1a по размерам и таблицам, от которых зависят гены и цели
+inline uint64_t instanceHash(const Instance& inst) {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](const void* data, size_t size) {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) h = (h ^ bytes[i]) * 1099511628211ull;
+    };
+    auto mixInt = [&](int64_t v) { mix(&v, sizeof(v)); };
+    auto mixVector = [&](const auto& v) {
+        mixInt(static_cast<int64_t>(v.size()));
+        if (!v.empty()) mix(v.data(), v.size() * sizeof(v[0]));
+    };
+    mixInt(inst.num_groups); mixInt(inst.num_teachers); mixInt(inst.num_rooms); mixInt(inst.num_subjects);
+    mixInt(inst.num_days); mixInt(inst.slots_per_day); mixInt(inst.lessons_per_group_per_day);
+    mixVector(inst.group_sizes);
+    mixVector(inst.room_capacities);
+    mixVector(inst.room_types);
+    mixVector(inst.target_pairs);
+    mixVector(inst.preferred_mask);
+    for (const auto& p : inst.teacher_subject_pairs) { mixInt(p.first); mixInt(p.second); }
+    return h;
+}
+
+// Состояние, которое сохраняется и восстанавливается
+struct State {
+    std::vector<const Schedule*> population;
+    std::vector<Schedule::Fitness> population_objectives;
+    std::vector<const Schedule*> archive;
+    std::vector<Schedule::Fitness> archive_objectives;
+    std::vector<const std::mt19937*> rngs;
+    int generation = 0;
+    long long evaluations = 0;
+};
+
+// Запись во временный файл и атомарная замена (AtomicFile): оборванная запись не портит прежний снимок
+inline void save(const std::string& path, const Instance& inst, const State& state) {
+    const size_t genes = static_cast<size_t>(inst.lessonsPerSchedule());
+    std::string rng_text;
+    {
+        std::ostringstream out;
+        for (const auto* rng : state.rngs) out << *rng << '\n';
+        rng_text = out.str();
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.lesson_size = sizeof(Lesson);
+    header.instance_hash = instanceHash(inst);
+    header.genes = static_cast<uint32_t>(genes);
+    header.population = static_cast<uint32_t>(state.population.size());
+    header.archive = static_cast<uint32_t>(state.archive.size());
+    header.rng_count = static_cast<uint32_t>(state.rngs.size());
+    header.generation = state.generation;
+    header.evaluations = state.evaluations;
+    header.rng_bytes = rng_text.size();
+
+    const std::string tmp = AtomicFile::tempPath(path);
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("не удалось открыть файл снимка: " + tmp);
+    static const char zeros[8] = {};
+    auto block = [&](const void* data, size_t size) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        out.write(zeros, static_cast<std::streamsize>(align8(size) - size));
+    };
+    auto schedules = [&](const std::vector<const Schedule*>& list) {
+        for (const auto* s : list) {
+            if (s->lessons.size() != genes) throw std::runtime_error("расписание не соответствует экземпляру задачи");
+            out.write(reinterpret_cast<const char*>(s->lessons.data()), static_cast<std::streamsize>(genes * sizeof(Lesson)));
+        }
+        size_t size = list.size() * genes * sizeof(Lesson);
+        out.write(zeros, static_cast<std::streamsize>(align8(size) - size));
+    };
+
+    block(&header, sizeof(header));
+    schedules(state.population);
+    block(state.population_objectives.data(), state.population_objectives.size() * sizeof(Schedule::Fitness));
+    schedules(state.archive);
+    block(state.archive_objectives.data(), state.archive_objectives.size() * sizeof(Schedule::Fitness));
+    block(rng_text.data(), rng_text.size());
+    out.close();
+    if (!out) throw std::runtime_error("ошибка записи снимка: " + tmp);
+    AtomicFile::replace(tmp, path);
+}
+
+// Файл только для чтения, отображённый в память (на Windows — прочитанный целиком)
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("не удалось открыть снимок: " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("не удалось прочитать снимок: " + path); }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { ::close(fd); throw std::runtime_error("не удалось отобразить снимок: " + path); }
+            mapped = static_cast<const char*>(p);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("не удалось открыть снимок: " + path);
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        length = buffer.size();
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) ::munmap(const_cast<char*>(mapped), length);
+#endif
+    }
+
+#ifndef _WIN32
+    const char* data() const { return mapped; }
+#else
+    const char* data() const { return buffer.data(); }
+#endif
+    size_t size() const { return length; }
+
+private:
+    size_t length = 0;
+#ifndef _WIN32
+    const char* mapped = nullptr;
+#else
+    std::vector<char> buffer;
+#endif
+};
+
+// Снимок, открытый для чтения. Конструктор проверяет заголовок, размеры
+// блоков и соответствие экземпляру задачи; при ошибке бросает std::runtime_error.
+// same_instance = false допускает снимок другого экземпляра с тем же числом
+// занятий в расписании (например, прошлого семестра): цели такого снимка
+// не используются. Гены любого снимка проверяются при чтении.
+class Snapshot {
+public:
+    Snapshot(const std::string& path, const Instance& inst, bool same_instance = true) : file(path), inst(&inst) {
+        if (file.size() < sizeof(Header)) throw std::runtime_error("снимок повреждён: " + path);
+        std::memcpy(&head, file.data(), sizeof(Header));
+        if (std::memcmp(head.magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("файл не является снимком: " + path);
+        if (head.version != VERSION || head.lesson_size != sizeof(Lesson))
+            throw std::runtime_error("неподдерживаемая версия снимка: " + path);
+        exact = head.instance_hash == instanceHash(inst);
+        if ((same_instance && !exact) || head.genes != static_cast<uint32_t>(inst.lessonsPerSchedule()))
+            throw std::runtime_error("снимок построен для другого экземпляра задачи: " + path);
+
+        size_t offset = align8(sizeof(Header));
+        population_genes = offset;
+        offset += align8(size_t(head.population) * head.genes * sizeof(Lesson));
+        population_objectives = offset;
+        offset += align8(size_t(head.population) * sizeof(Schedule::Fitness));
+        archive_genes = offset;
+        offset += align8(size_t(head.archive) * head.genes * sizeof(Lesson));
+        archive_objectives = offset;
+        offset += align8(size_t(head.archive) * sizeof(Schedule::Fitness));
+        rng_offset = offset;
+        offset += align8(head.rng_bytes);
+        if (offset != file.size()) throw std::runtime_error("снимок повреждён: " + path);
+        // rng_count из файла задаёт размер выделения в rngs(), поэтому сверяется с длиной текста состояний
+        if (head.rng_bytes > file.size() || uint64_t(head.rng_count) * MIN_RNG_TEXT > head.rng_bytes)
+            throw std::runtime_error("снимок повреждён: число состояний ГСЧ " + path);
+    }
+
+    const Header& header() const { return head; }
+    bool sameInstance() const { return exact; }
+    size_t populationSize() const { return head.population; }
+    size_t archiveSize() const { return head.archive; }
+
+    // Гены и цели i-й особи популяции или члена архива записываются в s
+    void population(size_t i, Schedule& s) const { read(population_genes, population_objectives, i, s); }
+    void archive(size_t i, Schedule& s) const { read(archive_genes, archive_objectives, i, s); }
+
+    Schedule::Fitness populationObjectives(size_t i) const { return objectives(population_objectives, i); }
+    Schedule::Fitness archiveObjectives(size_t i) const { return objectives(archive_objectives, i); }
+
+    // Состояния ГСЧ в порядке записи
+    std::vector<std::mt19937> rngs() const {
+        std::istringstream in(std::string(file.data() + rng_offset, head.rng_bytes));
+        std::vector<std::mt19937> result(head.rng_count);
+        for (auto& rng : result) in >> rng;
+        if (!in) throw std::runtime_error("снимок повреждён: состояние ГСЧ");
+        return result;
+    }
+
+private:
+    MappedFile file;
+    const Instance* inst;
+    Header head;
+    bool exact = false;
+    size_t population_genes = 0, population_objectives = 0, archive_genes = 0, archive_objectives = 0, rng_offset = 0;
+
+    Schedule::Fitness objectives(size_t block, size_t i) const {
+        Schedule::Fitness f;
+        std::memcpy(f.data(), file.data() + block + i * sizeof(Schedule::Fitness), sizeof(Schedule::Fitness));
+        return f;
+    }
+
+    void read(size_t genes_block, size_t objectives_block, size_t i, Schedule& s) const {
+        s.lessons.resize(head.genes);
+        std::memcpy(s.lessons.data(), file.data() + genes_block + i * head.genes * sizeof(Lesson), head.genes * sizeof(Lesson));
+        // Гены проверяются и при совпавшем хэше: файл мог быть повреждён после записи,
+        // а индексы из генов идут в таблицы экземпляра без проверки границ
+        for (const auto& l : s.lessons) {
+            if (l.group >= inst->num_groups || l.teacher >= inst->num_teachers || l.subject >= inst->num_subjects ||
+                l.room >= inst->num_rooms || l.day >= inst->num_days || l.slot >= inst->slots_per_day ||
+                l.type > LessonType::Lab)
+                throw std::runtime_error("расписание снимка не подходит к экземпляру задачи");
+        }
+        if (exact) s.restoreFitness(objectives(objectives_block, i));
+        else s.invalidateFitness();
+    }
+};
+
+// Расписания архива снимка как затравка нового прогона (см. GeneticAlgorithm::seed)
+inline std::vector<Schedule> seedSchedules(const std::string& path, const Instance& inst) {
+    Snapshot snapshot(path, inst, false);
+    std::vector<Schedule> result(snapshot.archiveSize(), Schedule(inst));
+    for (size_t i = 0; i < result.size(); ++i) snapshot.archive(i, result[i]);
+    return result;
+}
+
+} // namespace Checkpoint
@@ -2,6 +2,37 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <cmath>
+#include <cstdint>
+
+// Класс аудитории
+enum class RoomType : uint8_t { Lecture, Computer, Lab };
+
+inline const char* roomTypeName(RoomType t) {
+    switch (t) {
+    case RoomType::Lecture: return "Лекционная";
+    case RoomType::Computer: return "Компьютерная";
+    default: return "Лабораторная";
+    }
+}
+
+// Способ построения начальной популяции
+enum class InitStrategy : uint8_t { Random, Greedy };
+
+// Отбор в следующее поколение
+enum class Survival : uint8_t {
+    Generational,   // потомки заменяют популяцию, кроме одной элитной особи
+    MuPlusLambda,   // NSGA-II: родители и столько же потомков, лучшие по фронтам и crowding distance
+    SteadyState     // как MuPlusLambda, но потомков за шаг Config::STEADY_STATE_OFFSPRING
+};
+
+inline const char* survivalName(Survival s) {
+    switch (s) {
+    case Survival::Generational: return "generational";
+    case Survival::MuPlusLambda: return "mu+lambda";
+    default: return "steady-state";
+    }
+}
 
 namespace Config {
     // Основные параметры
@@ -15,6 +46,34 @@ namespace Config {
     const int POPULATION_SIZE = 50;         
     const int MAX_GENERATIONS = 500;       
     const double MUTATION_RATE = 0.15;      
+    const int NUM_THREADS = 0;              // Потоки GeneticAlgorithm, 0 — по числу ядер
+    const double REPAIR_RATE = 0.5;         // Доля потомков, проходящих ремонт и локальный поиск
+    const int LOCAL_SEARCH_STEPS = 100;     // Попыток переноса при локальном поиске
+    const size_t ARCHIVE_SIZE = 200;        // Предел внешнего архива недоминируемых расписаний
+    const int STALL_WINDOW = 50;            // solve: поколений без улучшения до остановки, 0 — не следить
+    const double STALL_TOLERANCE = 1e-3;    // solve: относительное улучшение, которое считается прогрессом
+    const int CHECKPOINT_INTERVAL = 50;     // solve: поколений между снимками состояния
+    const double RESCHEDULE_DEVIATION_WEIGHT = 0.05; // Перепланирование: вес отклонения от исходного расписания
+    const int RESCHEDULE_ROUNDS = 4;        // Перепланирование: кругов расширения множества двигаемых занятий
+    const bool SIMD_FITNESS = true;         // Штрафы занятий ядром AVX2, если процессор его поддерживает
+    const size_t SIMD_MIN_LESSONS = 4096;   // Меньшие расписания считаются скалярным циклом
+    const bool SHAPED_FITNESS = true;       // Экземпляры из KnownShapes (shaped_fitness.h) — оценкой фиксированной формы
+    const InitStrategy INIT_STRATEGY = InitStrategy::Greedy; // Начальная популяция: случайная или жадная
+    const Survival SURVIVAL = Survival::MuPlusLambda; // Отбор выживших
+    const int STEADY_STATE_OFFSPRING = 8;   // Потомков за шаг при Survival::SteadyState
+    const size_t EXPORT_BUFFER_SIZE = 1 << 20; // Буфер записи выгрузок (exporters.h), байт
+    const int FIRST_SLOT_MINUTES = 8 * 60 + 30; // Календари: начало первой пары, минут от полуночи
+    const int SLOT_MINUTES = 90;            // Календари: длительность пары
+    const int BREAK_MINUTES = 10;           // Календари: перерыв между парами
+    const int SEMESTER_WEEKS = 16;          // Календари: недель повторения расписания
+    const char* const SEMESTER_START = "2025-09-01"; // Календари: дата первого дня недели расписания
+    const int SERVICE_MAX_JOBS = 4;         // SolverService: одновременных прогонов, ядра делятся между ними поровну
+    const size_t SERVICE_MAX_LINE = 1 << 20; // paraplan_daemon: предел строки запроса из сокета, байт
+
+    // Островная модель
+    const int NUM_ISLANDS = 0;              // Число островов, 0 — по числу ядер
+    const int MIGRATION_INTERVAL = 10;      // Поколений между миграциями
+    const int MIGRANTS = 2;                 // Особей, отправляемых каждым островом
 
     // Весовые коэффициенты для фитнеса
     struct FitnessWeights {
@@ -40,9 +99,9 @@ namespace Config {
 
     // === Параметры аудиторий ===
     inline std::vector<int> room_capacities = { 30, 40, 20, 25, 50, 15 };
-    inline std::vector<std::string> room_types = {
-        "Лекционная", "Компьютерная", "Лабораторная",
-        "Лекционная", "Компьютерная", "Лабораторная"
+    inline std::vector<RoomType> room_types = {
+        RoomType::Lecture, RoomType::Computer, RoomType::Lab,
+        RoomType::Lecture, RoomType::Computer, RoomType::Lab
     };
 
     // Допустимые связи (преподаватель–предмет)
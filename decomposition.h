@@ -0,0 +1,188 @@
+#pragma once
+#include "genetic_algorithm.h"
+#include "repair.h"
+#include "thread_pool.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+
+// Подзадача: экземпляр с частью групп, преподавателей и аудиторий
+// и глобальные номера его локальных групп, преподавателей и аудиторий.
+// Предметы и дни общие, их номера не меняются.
+struct SubInstance {
+    Instance instance;
+    std::vector<int> groups;
+    std::vector<int> teachers;
+    std::vector<int> rooms;
+};
+
+// Разбиение экземпляра на parts независимых подзадач.
+// Группе подходит любой преподаватель своего предмета и любая аудитория
+// нужного класса, поэтому граф взаимодействия групп, преподавателей
+// и аудиторий связен и на компоненты не распадается. Вместо этого ресурсы
+// делятся между частями: группы — поровну с чередованием крупных и мелких,
+// преподаватели — по целевой нагрузке, чтобы часы каждой части покрывали
+// её пары, аудитории каждого класса — пропорционально числу пар части,
+// крупные первыми. Части не делят ни одного ресурса, поэтому их расписания
+// объединяются без накладок; недостающие части аудитории и нарушения
+// на стыке снимает общий ремонт (DecomposedSolver).
+// Число частей ограничено числом групп, аудиторий и преподавателей с предметами.
+inline std::vector<SubInstance> decompose(const Instance& inst, int parts) {
+    std::vector<int> teachers_with_subjects;
+    for (int t = 0; t < inst.num_teachers; ++t)
+        if (inst.subjectCount(t) > 0) teachers_with_subjects.push_back(t);
+    parts = std::max(1, std::min({ parts, inst.num_groups, inst.num_rooms, static_cast<int>(teachers_with_subjects.size()) }));
+
+    std::vector<SubInstance> result(parts);
+    std::vector<long long> lessons(parts, 0);
+
+    // Группы: по убыванию размера «змейкой», чтобы в частях были и крупные, и мелкие
+    std::vector<int> order(inst.num_groups);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return inst.group_sizes[a] > inst.group_sizes[b]; });
+    const long long per_group = static_cast<long long>(inst.num_days) * inst.lessons_per_group_per_day;
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t round = i / parts, pos = i % parts;
+        int part = static_cast<int>(round % 2 == 0 ? pos : parts - 1 - pos);
+        result[part].groups.push_back(order[i]);
+        lessons[part] += per_group;
+    }
+
+    // Преподаватели: по убыванию нагрузки в часть с наибольшей непокрытой долей пар.
+    // Первые parts преподавателей расходятся по одному, чтобы ни одна часть не осталась без них.
+    std::vector<long long> covered(parts, 0);
+    std::stable_sort(teachers_with_subjects.begin(), teachers_with_subjects.end(), [&](int a, int b) {
+        return inst.target_pairs[a] > inst.target_pairs[b];
+    });
+    for (size_t i = 0; i < teachers_with_subjects.size(); ++i) {
+        int t = teachers_with_subjects[i];
+        int part = 0;
+        if (i < static_cast<size_t>(parts)) part = static_cast<int>(i);
+        else {
+            for (int p = 1; p < parts; ++p)
+                if (lessons[p] - covered[p] > lessons[part] - covered[part]) part = p;
+        }
+        result[part].teachers.push_back(t);
+        covered[part] += inst.target_pairs[t];
+    }
+
+    // Аудитории каждого класса: по убыванию вместимости в часть с наименьшим числом аудиторий на пару
+    std::vector<int> room_count(parts, 0);
+    for (const auto& typed : inst.rooms_by_type) {
+        std::vector<int> assigned(parts, 0);
+        for (auto it = typed.rbegin(); it != typed.rend(); ++it) {
+            int part = 0;
+            for (int p = 1; p < parts; ++p)
+                if (assigned[p] * lessons[part] < assigned[part] * lessons[p]) part = p;
+            result[part].rooms.push_back(*it);
+            ++assigned[part];
+            ++room_count[part];
+        }
+    }
+    // Часть без аудиторий получает одну у части, где их больше всего
+    for (int p = 0; p < parts; ++p) {
+        if (room_count[p] > 0) continue;
+        int donor = static_cast<int>(std::max_element(room_count.begin(), room_count.end()) - room_count.begin());
+        result[p].rooms.push_back(result[donor].rooms.back());
+        result[donor].rooms.pop_back();
+        --room_count[donor];
+        ++room_count[p];
+    }
+
+    for (SubInstance& sub : result) {
+        std::sort(sub.rooms.begin(), sub.rooms.end());
+        Instance& s = sub.instance;
+        s.days = inst.days;
+        s.slots_per_day = inst.slots_per_day;
+        s.lessons_per_group_per_day = inst.lessons_per_group_per_day;
+        s.subjects = inst.subjects;
+        for (int g : sub.groups) {
+            s.groups.push_back(inst.groups[g]);
+            s.group_sizes.push_back(inst.group_sizes[g]);
+        }
+        for (int r : sub.rooms) {
+            s.rooms.push_back(inst.rooms[r]);
+            s.room_capacities.push_back(inst.room_capacities[r]);
+            s.room_types.push_back(inst.room_types[r]);
+        }
+        for (size_t local = 0; local < sub.teachers.size(); ++local) {
+            int t = sub.teachers[local];
+            s.teachers.push_back(inst.teachers[t]);
+            s.teacher_semester_hours.push_back(inst.teacher_semester_hours[t]);
+            s.teacher_preferred_days.push_back(inst.teacher_preferred_days[t]);
+            for (int k = 0; k < inst.subjectCount(t); ++k)
+                s.teacher_subject_pairs.emplace_back(static_cast<int>(local), inst.subjectAt(t, k));
+        }
+        s.finalize();
+    }
+    return result;
+}
+
+// Решение по частям: каждая подзадача решается своим GeneticAlgorithm
+// в отдельном потоке, из её архива берётся расписание с лучшей свёрткой
+// целей, расписания переводятся в глобальные номера и объединяются.
+// Затем общий ремонт и локальный поиск по всему экземпляру: занятия,
+// которым в своей части не хватило аудитории нужного класса или вместимости,
+// переносятся в аудитории других частей. Время решения определяется
+// самой крупной частью, а не всем институтом.
+class DecomposedSolver {
+public:
+    // num_threads = 0 — по числу аппаратных потоков; instance должен жить дольше решателя
+    DecomposedSolver(const Instance& instance, int parts, unsigned seed, size_t num_threads = Config::NUM_THREADS)
+        : instance(instance), subproblems(decompose(instance, parts)), pool(num_threads), seed(seed) {}
+
+    size_t size() const { return subproblems.size(); }
+    const SubInstance& part(size_t i) const { return subproblems[i]; }
+
+    // options действуют на каждую часть; обратный вызов on_progress вызывается из разных потоков
+    Schedule solve(const SolveOptions& options) {
+        std::seed_seq seq{ seed };
+        std::vector<unsigned> seeds(subproblems.size() + 1);
+        seq.generate(seeds.begin(), seeds.end());
+
+        std::vector<Schedule> best;
+        for (const auto& sub : subproblems) best.emplace_back(sub.instance);
+        pool.parallelFor(subproblems.size(), [&](size_t i) {
+            GeneticAlgorithm ga(subproblems[i].instance, seeds[i], 1);
+            ga.setConsoleOutput(false);
+            ga.solve(options);
+            const ParetoArchive& archive = ga.archive();
+            size_t pick = 0;
+            for (size_t k = 1; k < archive.size(); ++k) {
+                if (Schedule::weightedFitness(archive.objectives(k)) < Schedule::weightedFitness(archive.objectives(pick))) pick = k;
+            }
+            best[i] = archive.schedule(pick);
+        });
+
+        Schedule merged = merge(best);
+        std::mt19937 gen(seeds.back());
+        Repairer().repair(merged, gen, static_cast<int>(merged.lessons.size()));
+        return merged;
+    }
+
+    // Объединение расписаний частей: гены ставятся на места групп в порядке Schedule::initialize
+    Schedule merge(const std::vector<Schedule>& parts) const {
+        Schedule merged(instance);
+        merged.lessons.assign(instance.lessonsPerSchedule(), Lesson{});
+        const size_t per_group = static_cast<size_t>(instance.num_days) * instance.lessons_per_group_per_day;
+        for (size_t p = 0; p < parts.size(); ++p) {
+            const SubInstance& sub = subproblems[p];
+            const auto& lessons = parts[p].lessons;
+            for (size_t k = 0; k < lessons.size(); ++k) {
+                Lesson l = lessons[k];
+                l.group = static_cast<uint16_t>(sub.groups[l.group]);
+                l.teacher = static_cast<uint16_t>(sub.teachers[l.teacher]);
+                l.room = static_cast<uint16_t>(sub.rooms[l.room]);
+                merged.lessons[l.group * per_group + k % per_group] = l;
+            }
+        }
+        return merged;
+    }
+
+private:
+    const Instance& instance;
+    std::vector<SubInstance> subproblems;
+    ThreadPool pool;
+    unsigned seed;
+};
@@ -0,0 +1,472 @@
+#pragma once
+#include "schedule.h"
+#include "pareto_archive.h"
+#include "solve_options.h"
+#include "atomic_file.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <functional>
+
+// Выгрузка расписаний: текст для консоли, CSV и JSON всего фронта,
+// календари iCalendar по группам и преподавателям.
+// Занятия раскладываются по (группа, день, пара) один раз подсчётом, без
+// поиска и сортировки на каждый день; вывод идёт через собственный буфер
+// файла, числа форматируются без потоков ввода-вывода.
+namespace Export {
+
+// Буферизованная запись в файл: вывод копится в памяти и сбрасывается
+// блоками по Config::EXPORT_BUFFER_SIZE байт
+class BufferedWriter {
+public:
+    explicit BufferedWriter(const std::string& path) : file(std::fopen(path.c_str(), "wb")), owned(true), path(path) {
+        if (!file) throw std::runtime_error("не удалось открыть файл для записи: " + path);
+        buffer.resize(Config::EXPORT_BUFFER_SIZE);
+    }
+
+    // Запись в открытый поток (например, stdout); поток не закрывается
+    explicit BufferedWriter(std::FILE* stream) : file(stream), owned(false) { buffer.resize(Config::EXPORT_BUFFER_SIZE); }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    ~BufferedWriter() {
+        try { close(); }
+        catch (...) {}
+    }
+
+    BufferedWriter& write(const char* data, size_t size) {
+        if (used + size > buffer.size()) {
+            flush();
+            if (size > buffer.size()) {
+                put(data, size);
+                return *this;
+            }
+        }
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+        return *this;
+    }
+
+    BufferedWriter& operator<<(const std::string& s) { return write(s.data(), s.size()); }
+    BufferedWriter& operator<<(const char* s) { return write(s, std::strlen(s)); }
+    BufferedWriter& operator<<(char c) { return write(&c, 1); }
+
+    BufferedWriter& operator<<(long long value) {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        unsigned long long v = value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        do { *--p = static_cast<char>('0' + v % 10); v /= 10; } while (v);
+        if (value < 0) *--p = '-';
+        return write(p, static_cast<size_t>(end - p));
+    }
+    BufferedWriter& operator<<(int value) { return *this << static_cast<long long>(value); }
+    BufferedWriter& operator<<(size_t value) { return *this << static_cast<long long>(value); }
+
+    BufferedWriter& operator<<(double value) { return general(value, 9); }
+
+    // Число в формате %g с digits значащими цифрами (6 — как у std::ostream по умолчанию)
+    BufferedWriter& general(double value, int digits) {
+        char text[32];
+        int n = std::snprintf(text, sizeof(text), "%.*g", digits, value);
+        return write(text, static_cast<size_t>(n));
+    }
+
+    // Два знака с ведущим нулём: даты и время iCalendar
+    BufferedWriter& twoDigits(int value) {
+        char text[2] = { static_cast<char>('0' + value / 10 % 10), static_cast<char>('0' + value % 10) };
+        return write(text, 2);
+    }
+
+    void flush() {
+        put(buffer.data(), used);
+        used = 0;
+    }
+
+    void close() {
+        if (!file) return;
+        flush();
+        std::fflush(file);
+        bool failed = std::ferror(file) != 0;
+        if (owned) failed |= std::fclose(file) != 0;
+        file = nullptr;
+        if (failed) throw std::runtime_error("ошибка записи: " + (path.empty() ? std::string("поток вывода") : path));
+    }
+
+private:
+    std::FILE* file;
+    bool owned;
+    std::string path;
+    std::vector<char> buffer;
+    size_t used = 0;
+
+    void put(const char* data, size_t size) {
+        if (size && std::fwrite(data, 1, size, file) != size)
+            throw std::runtime_error("ошибка записи: " + (path.empty() ? std::string("поток вывода") : path));
+    }
+};
+
+// Занятия расписания, разложенные подсчётом по ключам (группа, день, пара)
+// и (преподаватель, день, пара): занятия группы за день и все занятия
+// преподавателя лежат подряд и уже упорядочены по времени
+class ScheduleIndex {
+public:
+    explicit ScheduleIndex(const Schedule& s) {
+        const Instance& inst = s.instance();
+        slots = inst.slots_per_day;
+        cells = inst.num_days * slots;
+        bucket(s, inst.num_groups, [](const Lesson& l) { return l.group; }, group_offsets, by_group);
+        bucket(s, inst.num_teachers, [](const Lesson& l) { return l.teacher; }, teacher_offsets, by_teacher);
+    }
+
+    // Непрерывный отрезок индекса в порядке дней и пар
+    struct Range {
+        const Lesson* const* first;
+        const Lesson* const* last;
+        const Lesson* const* begin() const { return first; }
+        const Lesson* const* end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
+    Range group(int g) const { return range(group_offsets, by_group, g * cells, (g + 1) * cells); }
+    Range groupDay(int g, int d) const { return range(group_offsets, by_group, g * cells + d * slots, g * cells + (d + 1) * slots); }
+    Range teacher(int t) const { return range(teacher_offsets, by_teacher, t * cells, (t + 1) * cells); }
+
+private:
+    int slots = 0;
+    int cells = 0;
+    std::vector<int> group_offsets, teacher_offsets;
+    std::vector<const Lesson*> by_group, by_teacher;
+
+    template <class Key>
+    void bucket(const Schedule& s, int owners, Key key, std::vector<int>& offsets, std::vector<const Lesson*>& order) {
+        offsets.assign(static_cast<size_t>(owners) * cells + 1, 0);
+        for (const Lesson& l : s.lessons) offsets[static_cast<size_t>(key(l)) * cells + l.day * slots + l.slot + 1]++;
+        for (size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+        order.assign(s.lessons.size(), nullptr);
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (const Lesson& l : s.lessons) order[fill[static_cast<size_t>(key(l)) * cells + l.day * slots + l.slot]++] = &l;
+    }
+
+    static Range range(const std::vector<int>& offsets, const std::vector<const Lesson*>& order, int from, int to) {
+        return { order.data() + offsets[from], order.data() + offsets[to] };
+    }
+};
+
+// Фронт для выгрузки: вектор расписаний или архив работающего решателя
+struct FrontView {
+    const std::vector<Schedule>* schedules = nullptr;
+    const ParetoArchive* archive = nullptr;
+
+    FrontView(const std::vector<Schedule>& s) : schedules(&s) {}
+    FrontView(const ParetoArchive& a) : archive(&a) {}
+
+    size_t size() const { return schedules ? schedules->size() : archive->size(); }
+    const Schedule& schedule(size_t i) const { return schedules ? (*schedules)[i] : archive->schedule(i); }
+    const Schedule::Fitness& objectives(size_t i) const { return schedules ? (*schedules)[i].fitness() : archive->objectives(i); }
+};
+
+// Поле CSV в кавычках, если в нём есть запятая, кавычка или перевод строки
+inline std::string csvQuote(const std::string& s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+inline std::string jsonQuote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                out += code;
+            }
+            else out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Имена справочников экземпляра, заранее обработанные quote: строки занятий
+// собираются из готовых кусков, а не экранируются посимвольно на каждом занятии
+struct QuotedNames {
+    const Instance* instance = nullptr;
+    std::vector<std::string> groups, days, subjects, teachers, rooms, types;
+
+    template <class Quote>
+    void build(const Instance& inst, Quote quote) {
+        if (instance == &inst) return;
+        instance = &inst;
+        auto all = [&](const std::vector<std::string>& names, std::vector<std::string>& out) {
+            out.clear();
+            for (const auto& n : names) out.push_back(quote(n));
+        };
+        all(inst.groups, groups);
+        all(inst.days, days);
+        all(inst.subjects, subjects);
+        all(inst.teachers, teachers);
+        all(inst.rooms, rooms);
+        types.clear();
+        for (LessonType t : { LessonType::Lecture, LessonType::Practice, LessonType::Lab }) types.push_back(quote(lessonTypeName(t)));
+    }
+};
+
+// Текстовое расписание по группам и дням, как его печатает paraplan
+inline void writeText(BufferedWriter& out, const Schedule& s, size_t index) {
+    const Instance& inst = s.instance();
+    const auto& fitness = s.fitness();
+    out << "\n=== Расписание " << index + 1 << " (Конфликты = ";
+    out.general(fitness[0], 6) << ", Окна = ";
+    out.general(fitness[1], 6) << ", Баланс = ";
+    out.general(fitness[2], 6) << ") ===\n";
+    ScheduleIndex idx(s);
+    for (int g = 0; g < inst.num_groups; ++g) {
+        out << "\nГруппа: " << inst.groups[g] << "\n";
+        for (int d = 0; d < inst.num_days; ++d) {
+            out << "  " << inst.days[d] << ":\n";
+            for (const Lesson* l : idx.groupDay(g, d)) {
+                out << "    Лента " << l->slot + 1 << ": " << inst.subjects[l->subject] << " ведет "
+                    << inst.teachers[l->teacher] << " в аудитории " << inst.rooms[l->room] << " ("
+                    << lessonTypeName(l->type) << ")\n";
+            }
+        }
+    }
+}
+
+// Все занятия фронта одной таблицей, по расписаниям, группам, дням и парам
+inline void writeCsv(BufferedWriter& out, const FrontView& front) {
+    out << "schedule,group,day,slot,subject,teacher,room,type\n";
+    QuotedNames names;
+    for (size_t i = 0; i < front.size(); ++i) {
+        const Schedule& s = front.schedule(i);
+        const Instance& inst = s.instance();
+        names.build(inst, csvQuote);
+        ScheduleIndex idx(s);
+        for (int g = 0; g < inst.num_groups; ++g) {
+            for (const Lesson* l : idx.group(g)) {
+                out << i + 1 << ',' << names.groups[l->group] << ',' << names.days[l->day] << ',' << l->slot + 1 << ','
+                    << names.subjects[l->subject] << ',' << names.teachers[l->teacher] << ',' << names.rooms[l->room] << ','
+                    << names.types[static_cast<int>(l->type)] << '\n';
+            }
+        }
+    }
+}
+
+// Фронт массивом объектов: значения целей, их свёртка и занятия по группам, дням и парам
+inline void writeJson(BufferedWriter& out, const FrontView& front) {
+    out << "[";
+    QuotedNames names;
+    for (size_t i = 0; i < front.size(); ++i) {
+        const Schedule& s = front.schedule(i);
+        const Instance& inst = s.instance();
+        names.build(inst, jsonQuote);
+        const auto& f = front.objectives(i);
+        out << (i ? ",\n" : "\n") << "{\"objectives\":[";
+        for (size_t k = 0; k < f.size(); ++k) out << (k ? "," : "") << f[k];
+        out << "],\"weighted\":" << Schedule::weightedFitness(f) << ",\"lessons\":[";
+        ScheduleIndex idx(s);
+        const char* separator = "";
+        for (int g = 0; g < inst.num_groups; ++g) {
+            for (const Lesson* l : idx.group(g)) {
+                out << separator << "{\"group\":" << names.groups[l->group] << ",\"day\":" << names.days[l->day]
+                    << ",\"slot\":" << l->slot + 1 << ",\"subject\":" << names.subjects[l->subject]
+                    << ",\"teacher\":" << names.teachers[l->teacher] << ",\"room\":" << names.rooms[l->room]
+                    << ",\"type\":" << names.types[static_cast<int>(l->type)] << '}';
+                separator = ",";
+            }
+        }
+        out << "]}";
+    }
+    out << "\n]\n";
+}
+
+// Дата григорианского календаря; дни считаются от 1970-01-01
+struct Date {
+    int year = 1970, month = 1, day = 1;
+
+    // Разбор «ГГГГ-ММ-ДД»; день проверяется по длине месяца с учётом високосных лет
+    static Date parse(const std::string& text) {
+        Date d;
+        if (std::sscanf(text.c_str(), "%d-%d-%d", &d.year, &d.month, &d.day) != 3 || d.month < 1 || d.month > 12)
+            throw std::runtime_error("дата должна иметь вид ГГГГ-ММ-ДД: " + text);
+        if (d.day < 1 || d.day > daysInMonth(d.year, d.month))
+            throw std::runtime_error("несуществующая дата: " + text);
+        return d;
+    }
+
+    static bool isLeap(int year) { return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0; }
+
+    static int daysInMonth(int year, int month) {
+        static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return month == 2 && isLeap(year) ? 29 : days[month - 1];
+    }
+
+    long long toDays() const {
+        int y = year - (month <= 2);
+        long long era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<long long>(doe) - 719468;
+    }
+
+    static Date fromDays(long long z) {
+        z += 719468;
+        long long era = (z >= 0 ? z : z - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        Date d;
+        d.day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        d.month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        d.year = static_cast<int>(yoe + era * 400 + (d.month <= 2));
+        return d;
+    }
+};
+
+// Строка содержимого iCalendar: экранирование текста и перенос строк длиннее 75 байт
+// (RFC 5545, 3.1) без разрыва многобайтовых символов UTF-8
+class ICalendarLine {
+public:
+    explicit ICalendarLine(BufferedWriter& out) : out(out) {}
+
+    void property(const char* name, const std::string& text) {
+        begin(name);
+        for (char c : text) {
+            if (c == '\\' || c == ';' || c == ',') { raw("\\", 1); raw(&c, 1); }
+            else if (c == '\n') raw("\\n", 2);
+            else if (c != '\r') raw(&c, 1);
+        }
+        end();
+    }
+
+    void begin(const char* name) {
+        length = 0;
+        raw(name, std::strlen(name));
+        raw(":", 1);
+    }
+
+    // Перенос решается на первом байте символа по длине всей его последовательности UTF-8,
+    // поэтому строка с переносами не длиннее 75 байт, а символ не разрывается
+    void raw(const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            const unsigned char c = static_cast<unsigned char>(data[i]);
+            if ((c & 0xC0) != 0x80 && length + sequenceLength(c) > 75) {
+                out << "\r\n ";
+                length = 1;
+            }
+            out << data[i];
+            ++length;
+        }
+    }
+
+    void end() { out << "\r\n"; }
+
+private:
+    BufferedWriter& out;
+    size_t length = 0;
+
+    static size_t sequenceLength(unsigned char lead) {
+        if (lead >= 0xF0) return 4;
+        if (lead >= 0xE0) return 3;
+        if (lead >= 0xC0) return 2;
+        return 1;
+    }
+};
+
+// Календарь одной группы или одного преподавателя: занятия повторяются каждую
+// неделю Config::SEMESTER_WEEKS раз, день 0 экземпляра приходится на start.
+// Время пар — по Config::FIRST_SLOT_MINUTES, SLOT_MINUTES и BREAK_MINUTES, без часового пояса.
+inline void writeICalendar(BufferedWriter& out, const Schedule& s, const ScheduleIndex::Range& lessons,
+    const std::string& calendar_name, const std::string& uid_prefix, const Date& start) {
+    const Instance& inst = s.instance();
+    const long long day0 = start.toDays();
+    ICalendarLine line(out);
+    out << "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//Paraplan//Paraplan//RU\r\nCALSCALE:GREGORIAN\r\n";
+    line.property("X-WR-CALNAME", calendar_name);
+
+    // DTSTAMP по RFC 5545 записывается в UTC, время занятий — местное «плавающее»
+    auto stamp = [&](const char* name, const Date& d, int minutes, bool utc) {
+        line.begin(name);
+        out << static_cast<long long>(d.year);
+        out.twoDigits(d.month).twoDigits(d.day) << 'T';
+        out.twoDigits(minutes / 60).twoDigits(minutes % 60) << (utc ? "00Z" : "00");
+        line.end();
+    };
+
+    for (const Lesson* l : lessons) {
+        const Date date = Date::fromDays(day0 + l->day);
+        const int from = Config::FIRST_SLOT_MINUTES + l->slot * (Config::SLOT_MINUTES + Config::BREAK_MINUTES);
+        out << "BEGIN:VEVENT\r\n";
+        line.begin("UID");
+        out << uid_prefix << '-' << static_cast<long long>(l - s.lessons.data()) << "@paraplan";
+        line.end();
+        stamp("DTSTAMP", start, 0, true);
+        stamp("DTSTART", date, from, false);
+        stamp("DTEND", date, from + Config::SLOT_MINUTES, false);
+        out << "RRULE:FREQ=WEEKLY;COUNT=" << Config::SEMESTER_WEEKS << "\r\n";
+        line.property("SUMMARY", inst.subjects[l->subject] + " (" + lessonTypeName(l->type) + ")");
+        line.property("LOCATION", inst.rooms[l->room]);
+        line.property("DESCRIPTION", inst.groups[l->group] + ", " + inst.teachers[l->teacher]);
+        out << "END:VEVENT\r\n";
+    }
+    out << "END:VCALENDAR\r\n";
+}
+
+// Запись во временный файл и атомарная замена (AtomicFile): читатель файла не видит его недописанным
+template <class Write>
+inline void replaceFile(const std::string& path, Write write) {
+    const std::string tmp = AtomicFile::tempPath(path);
+    {
+        BufferedWriter out(tmp);
+        write(out);
+        out.close();
+    }
+    AtomicFile::replace(tmp, path);
+}
+
+// Календари расписания в каталоге dir: group_<номер>.ics и teacher_<номер>.ics
+// (номера с 1, имена — в X-WR-CALNAME); каталог должен существовать. Каждый файл
+// заменяется через replaceFile, как CSV и JSON
+inline void writeCalendars(const std::string& dir, const Schedule& s, const Date& start) {
+    const Instance& inst = s.instance();
+    ScheduleIndex idx(s);
+    for (int g = 0; g < inst.num_groups; ++g) {
+        replaceFile(dir + "/group_" + std::to_string(g + 1) + ".ics", [&](BufferedWriter& out) {
+            writeICalendar(out, s, idx.group(g), inst.groups[g], "g" + std::to_string(g), start);
+        });
+    }
+    for (int t = 0; t < inst.num_teachers; ++t) {
+        ScheduleIndex::Range lessons = idx.teacher(t);
+        if (lessons.empty()) continue;
+        replaceFile(dir + "/teacher_" + std::to_string(t + 1) + ".ics", [&](BufferedWriter& out) {
+            writeICalendar(out, s, lessons, inst.teachers[t], "t" + std::to_string(t), start);
+        });
+    }
+}
+
+// Обработчик SolveOptions::on_progress, который во время поиска каждые
+// interval поколений перезаписывает path текущим архивом в JSON
+inline std::function<void(const SolveProgress&)> streamArchive(const std::string& path, int interval = 1) {
+    return [path, interval](const SolveProgress& p) {
+        if (interval > 1 && p.generation % interval != 0) return;
+        replaceFile(path, [&](BufferedWriter& out) { writeJson(out, p.front); });
+    };
+}
+
+} // namespace Export
@@ -0,0 +1,146 @@
+#pragma once
+#include "lesson.h"
+#include "instance.h"
+#include <cstddef>
+#include <cstdint>
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PARAPLAN_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+// Штрафы отдельных занятий за один проход по гену: нехватка мест, неподходящий
+// класс аудитории и непредпочтительный день преподавателя. Сравнения без
+// ветвлений; на процессорах с AVX2 восемь занятий обрабатываются за шаг
+// (поля раскладываются перестановками из трёх загрузок массива Lesson,
+// справочники берутся векторной выборкой по номерам).
+// Вариант выбирается один раз во время выполнения, скалярный — запасной.
+// Накладки и нагрузка преподавателей считаются по индексу занятости и
+// гистограмме: это разброс записей по таблицам, который AVX2 не ускоряет.
+namespace FitnessKernel {
+
+struct Counts {
+    long long capacity = 0;
+    long long type = 0;
+    long long preference = 0;
+};
+
+inline Counts countScalar(const Instance& inst, const Lesson* lessons, size_t n) {
+    const int* group_sizes = inst.group_sizes.data();
+    const int* capacities = inst.room_capacities.data();
+    const RoomType* room_types = inst.room_types.data();
+    const uint64_t* preferred = inst.preferred_mask.data();
+    Counts c;
+    for (size_t i = 0; i < n; ++i) {
+        const Lesson& l = lessons[i];
+        c.capacity += group_sizes[l.group] > capacities[l.room];
+        c.type += room_types[l.room] != requiredRoomType(l.type);
+        c.preference += !((preferred[l.teacher] >> l.day) & 1);
+    }
+    return c;
+}
+
+#ifdef PARAPLAN_AVX2_KERNEL
+// Раскладка Lesson по 32-битным словам: [group | teacher], [subject | room], [day | slot | type]
+static_assert(sizeof(Lesson) == 12 && offsetof(Lesson, teacher) == 2 && offsetof(Lesson, room) == 6 &&
+    offsetof(Lesson, day) == 8 && offsetof(Lesson, type) == 10, "раскладка Lesson не совпадает с векторным ядром");
+
+__attribute__((target("avx2"))) inline long long horizontalSum(__m256i v) {
+    alignas(32) int32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    long long sum = 0;
+    for (int32_t x : lanes) sum += x;
+    return sum;
+}
+
+// Предпочтения берутся младшими 32 битами маски, поэтому ядро требует не более 32 дней
+__attribute__((target("avx2"))) inline Counts countAvx2(const Instance& inst, const Lesson* lessons, size_t n) {
+    const int* words = reinterpret_cast<const int*>(lessons);
+    const int* group_sizes = inst.group_sizes.data();
+    const int* capacities = inst.room_capacities.data();
+    const int* room_types = inst.room_type_codes.data();
+    const int* preferred = reinterpret_cast<const int*>(inst.preferred_mask.data());
+
+    // Восемь занятий — 24 слова в трёх загрузках; перестановки раскладывают их по полям
+    const __m256i pick_a0 = _mm256_setr_epi32(0, 3, 6, 0, 0, 0, 0, 0);
+    const __m256i pick_b0 = _mm256_setr_epi32(0, 0, 0, 1, 4, 7, 0, 0);
+    const __m256i pick_c0 = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 2, 5);
+    const __m256i pick_a1 = _mm256_setr_epi32(1, 4, 7, 0, 0, 0, 0, 0);
+    const __m256i pick_b1 = _mm256_setr_epi32(0, 0, 0, 2, 5, 0, 0, 0);
+    const __m256i pick_c1 = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 3, 6);
+    const __m256i pick_a2 = _mm256_setr_epi32(2, 5, 0, 0, 0, 0, 0, 0);
+    const __m256i pick_b2 = _mm256_setr_epi32(0, 0, 0, 3, 6, 0, 0, 0);
+    const __m256i pick_c2 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 4, 7);
+    const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+    const __m256i low8 = _mm256_set1_epi32(0xFF);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i required = _mm256_setr_epi32(static_cast<int>(requiredRoomType(LessonType::Lecture)),
+        static_cast<int>(requiredRoomType(LessonType::Practice)), static_cast<int>(requiredRoomType(LessonType::Lab)), 0, 0, 0, 0, 0);
+    __m256i capacity = _mm256_setzero_si256();
+    __m256i type = _mm256_setzero_si256();
+    __m256i preference = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(words + i * 3);
+        __m256i a = _mm256_loadu_si256(p);
+        __m256i b = _mm256_loadu_si256(p + 1);
+        __m256i c = _mm256_loadu_si256(p + 2);
+        __m256i w0 = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(a, pick_a0),
+            _mm256_permutevar8x32_epi32(b, pick_b0), 0x38), _mm256_permutevar8x32_epi32(c, pick_c0), 0xC0);
+        __m256i w1 = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(a, pick_a1),
+            _mm256_permutevar8x32_epi32(b, pick_b1), 0x18), _mm256_permutevar8x32_epi32(c, pick_c1), 0xE0);
+        __m256i w2 = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(a, pick_a2),
+            _mm256_permutevar8x32_epi32(b, pick_b2), 0x1C), _mm256_permutevar8x32_epi32(c, pick_c2), 0xE0);
+        __m256i group = _mm256_and_si256(w0, low16);
+        __m256i teacher = _mm256_srli_epi32(w0, 16);
+        __m256i room = _mm256_srli_epi32(w1, 16);
+        __m256i day = _mm256_and_si256(w2, low8);
+        __m256i lesson_type = _mm256_and_si256(_mm256_srli_epi32(w2, 16), low8);
+
+        // Сравнение даёт -1 в истинных дорожках: вычитание прибавляет единицу
+        __m256i size = _mm256_i32gather_epi32(group_sizes, group, 4);
+        __m256i cap = _mm256_i32gather_epi32(capacities, room, 4);
+        capacity = _mm256_sub_epi32(capacity, _mm256_cmpgt_epi32(size, cap));
+
+        __m256i actual = _mm256_i32gather_epi32(room_types, room, 4);
+        __m256i needed = _mm256_permutevar8x32_epi32(required, lesson_type);
+        type = _mm256_add_epi32(type, _mm256_andnot_si256(_mm256_cmpeq_epi32(actual, needed), one));
+
+        __m256i mask = _mm256_i32gather_epi32(preferred, teacher, 8);
+        __m256i allowed = _mm256_and_si256(_mm256_srlv_epi32(mask, day), one);
+        preference = _mm256_add_epi32(preference, _mm256_xor_si256(allowed, one));
+    }
+
+    Counts c = countScalar(inst, lessons + i, n - i);
+    c.capacity += horizontalSum(capacity);
+    c.type += horizontalSum(type);
+    c.preference += horizontalSum(preference);
+    return c;
+}
+
+inline bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+// Векторный вариант, если процессор его поддерживает и Config::SIMD_FITNESS включён
+inline bool simdAvailable(const Instance& inst) {
+#ifdef PARAPLAN_AVX2_KERNEL
+    return Config::SIMD_FITNESS && inst.num_days <= 32 && hasAvx2();
+#else
+    (void)inst;
+    return false;
+#endif
+}
+
+// На малых экземплярах справочники лежат в L1 и скалярный цикл не медленнее выборок,
+// поэтому векторное ядро берётся начиная с Config::SIMD_MIN_LESSONS занятий
+inline Counts count(const Instance& inst, const Lesson* lessons, size_t n) {
+#ifdef PARAPLAN_AVX2_KERNEL
+    if (n >= Config::SIMD_MIN_LESSONS && simdAvailable(inst)) return countAvx2(inst, lessons, n);
+#endif
+    return countScalar(inst, lessons, n);
+}
+
+} // namespace FitnessKernel
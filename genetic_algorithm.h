@@ -1,183 +1,545 @@
 #pragma once
 #include "schedule.h"
+#include "non_dominated_sort.h"
+#include "pareto_archive.h"
+#include "thread_pool.h"
+#include "repair.h"
+#include "greedy_initializer.h"
+#include "telemetry.h"
+#include "solve_options.h"
+#include "checkpoint.h"
+#include "alloc_counter.h"
 #include <random>
 #include <iostream>
 #include <algorithm>
-#include <set>
+#include <limits>
+#include <chrono>
 
 class GeneticAlgorithm {
 private:
+    const Instance& instance;
     std::vector<Schedule> population;
     std::mt19937 gen;
 
+    // Пул потоков и независимые потоки случайных чисел для каждой части популяции.
+    // Работа делится на части статически, поэтому результат воспроизводим
+    // при одинаковых зерне и числе потоков.
+    ThreadPool pool;
+    std::vector<std::mt19937> worker_gens;
+    std::vector<Repairer> repairers; // Буферы ремонта для каждой части популяции
+
+    // Телеметрия: время фаз по частям популяции, сводка последнего поколения и трасса
+    struct alignas(64) WorkerTimes {
+        PhaseTimes times;
+    };
+    std::vector<WorkerTimes> worker_times;
+    GenerationStats stats;
+    TraceWriter trace;
+    bool console_output = true;
+    std::vector<double> median_buffer;
+
     // Структура для хранения информации о ранге и crowding distance
     struct Individual {
         Schedule schedule;
+        Schedule::Fitness objectives; // Значения целей, считаются один раз при создании
         int rank;
         double crowding_distance;
-        Individual(const Schedule& s) : schedule(s), rank(0), crowding_distance(0.0) {}
+        Individual() : objectives{}, rank(0), crowding_distance(0.0) {}
+        Individual(Schedule s) : schedule(std::move(s)), objectives(schedule.fitness()), rank(0), crowding_distance(0.0) {}
     };
 
-    // Проверка доминирования
-    bool dominates(const std::vector<double>& a, const std::vector<double>& b) const {
-        bool at_least_one_better = false;
-        for (size_t i = 0; i < a.size(); ++i) {
-            if (a[i] > b[i]) return false; // a не доминирует b, если хуже хотя бы в одной цели
-            if (a[i] < b[i]) at_least_one_better = true;
-        }
-        return at_least_one_better;
-    }
+    // Текущая популяция с рангами и буфер потомков.
+    // Потомки пишутся в уже выделенные слоты, а выжившие переходят в популяцию
+    // обменом слотов, так что в установившемся режиме память не выделяется.
+    std::vector<Individual> pop;
+    std::vector<Individual> next_pop;
+    Survival survival = Config::SURVIVAL;
+    std::vector<int> survivors;     // Номера в объединении родителей и потомков
+    std::vector<char> kept;
+    int generation_count = 0;
+    long long evaluation_count = 0;     // Полных оценок с последнего reset
 
-    // Сортировка по не доминированию
-    void nonDominatedSort(std::vector<Individual>& pop) {
-        std::vector<std::set<int>> fronts;
-        std::vector<int> domination_count(pop.size(), 0);
-        std::vector<std::set<int>> dominated_by(pop.size());
+    // Все оценённые потомки предлагаются архиву: хорошие компромиссы
+    // ранних поколений не теряются при смене популяции
+    ParetoArchive pareto_archive;
+
+    // Буферы сортировки переиспользуются между поколениями
+    NonDominatedSorter sorter;
+    std::vector<Schedule::Fitness> objective_matrix;
+    std::vector<int> ranks;
+    std::vector<double> crowding;
 
-        // Шаг 1: Определяем доминирование
+    // Сортировка по не доминированию и crowding distance по всем целям
+    void nonDominatedSort(std::vector<Individual>& pop) {
+        objective_matrix.resize(pop.size());
+        for (size_t i = 0; i < pop.size(); ++i) objective_matrix[i] = pop[i].objectives;
+        sorter.sort(objective_matrix, ranks, crowding);
         for (size_t i = 0; i < pop.size(); ++i) {
-            auto fitness_i = pop[i].schedule.calculateFitness();
-            for (size_t j = 0; j < pop.size(); ++j) {
-                if (i == j) continue;
-                auto fitness_j = pop[j].schedule.calculateFitness();
-                if (dominates(fitness_i, fitness_j)) {
-                    dominated_by[i].insert(j);
-                }
-                else if (dominates(fitness_j, fitness_i)) {
-                    domination_count[i]++;
-                }
-            }
-            if (domination_count[i] == 0) {
-                pop[i].rank = 0;
-                if (fronts.empty()) fronts.push_back({});
-                fronts[0].insert(i);
-            }
+            pop[i].rank = ranks[i];
+            pop[i].crowding_distance = crowding[i];
         }
+        stats.phases[Phase::Sorting] += sorter.lastSortSeconds();
+        stats.phases[Phase::Crowding] += sorter.lastCrowdingSeconds();
+    }
 
-        // Шаг 2: Формируем фронты
-        size_t front_idx = 0;
-        while (!fronts[front_idx].empty()) {
-            std::set<int> next_front;
-            for (int i : fronts[front_idx]) {
-                for (int j : dominated_by[i]) {
-                    domination_count[j]--;
-                    if (domination_count[j] == 0) {
-                        pop[j].rank = front_idx + 1;
-                        next_front.insert(j);
-                    }
-                }
-            }
-            fronts.push_back(next_front);
-            front_idx++;
+    Schedule::Fitness archiveMinima() const {
+        Schedule::Fitness minima;
+        minima.fill(std::numeric_limits<double>::infinity());
+        for (size_t i = 0; i < pareto_archive.size(); ++i)
+            for (size_t k = 0; k < minima.size(); ++k) minima[k] = std::min(minima[k], pareto_archive.objectives(i)[k]);
+        return minima;
+    }
+
+    double archiveBestWeighted() const {
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < pareto_archive.size(); ++i)
+            best = std::min(best, Schedule::weightedFitness(pareto_archive.objectives(i)));
+        return best;
+    }
+
+    long long moveEvaluations() const {
+        long long total = 0;
+        for (const auto& r : repairers) total += r.moveEvaluations();
+        return total;
+    }
+
+    // Минимум и медиана каждой цели по популяции
+    void summarizeObjectives() {
+        median_buffer.resize(pop.size());
+        if (median_buffer.empty()) return;
+        for (size_t k = 0; k < Schedule::NUM_OBJECTIVES; ++k) {
+            for (size_t i = 0; i < pop.size(); ++i) median_buffer[i] = pop[i].objectives[k];
+            auto middle = median_buffer.begin() + median_buffer.size() / 2;
+            std::nth_element(median_buffer.begin(), middle, median_buffer.end());
+            stats.median[k] = *middle;
+            stats.best[k] = *std::min_element(median_buffer.begin(), middle + 1);
         }
+        stats.front_size = frontSize();
+    }
 
-        // Шаг 3: Вычисление crowding distance
-        for (size_t f = 0; f < fronts.size() - 1; ++f) { // Последний фронт может быть пустым
-            std::vector<int> front(fronts[f].begin(), fronts[f].end());
-            if (front.size() <= 1) continue;
+    // Число потомков за поколение (шаг) при текущей схеме отбора
+    size_t offspringCount() const {
+        switch (survival) {
+        case Survival::Generational: return pop.size() - 1;
+        case Survival::MuPlusLambda: return pop.size();
+        default: return std::min<size_t>(Config::STEADY_STATE_OFFSPRING, pop.size());
+        }
+    }
 
-            for (size_t obj = 0; obj < 5; ++obj) { // Для каждой цели (теперь 5)
-                std::sort(front.begin(), front.end(), [&](int i, int j) {
-                    return pop[i].schedule.calculateFitness()[obj] < pop[j].schedule.calculateFitness()[obj];
-                    });
+    // Отбор (mu + lambda) как в NSGA-II: родители и потомки сортируются вместе,
+    // выживают целые фронты по порядку, последний — по убыванию crowding distance.
+    // Отвергнутые родители меняются слотами с выжившими потомками.
+    void environmentalSelection() {
+        const size_t mu = pop.size();
+        const size_t total = mu + next_pop.size();
+        objective_matrix.resize(total);
+        for (size_t i = 0; i < mu; ++i) objective_matrix[i] = pop[i].objectives;
+        for (size_t i = 0; i < next_pop.size(); ++i) objective_matrix[mu + i] = next_pop[i].objectives;
+        sorter.sort(objective_matrix, ranks, crowding);
+        stats.phases[Phase::Sorting] += sorter.lastSortSeconds();
+        stats.phases[Phase::Crowding] += sorter.lastCrowdingSeconds();
 
-                pop[front.front()].crowding_distance = pop[front.back()].crowding_distance = std::numeric_limits<double>::infinity();
-                double max_val = pop[front.back()].schedule.calculateFitness()[obj];
-                double min_val = pop[front.front()].schedule.calculateFitness()[obj];
-                double range = max_val - min_val;
-                if (range == 0) continue;
+        survivors.resize(total);
+        for (size_t i = 0; i < total; ++i) survivors[i] = static_cast<int>(i);
+        std::nth_element(survivors.begin(), survivors.begin() + mu, survivors.end(), [&](int a, int b) {
+            if (ranks[a] != ranks[b]) return ranks[a] < ranks[b];
+            if (crowding[a] != crowding[b]) return crowding[a] > crowding[b];
+            return a < b;
+        });
+        kept.assign(total, 0);
+        for (size_t i = 0; i < mu; ++i) kept[survivors[i]] = 1;
 
-                for (size_t i = 1; i < front.size() - 1; ++i) {
-                    pop[front[i]].crowding_distance += (pop[front[i + 1]].schedule.calculateFitness()[obj] -
-                        pop[front[i - 1]].schedule.calculateFitness()[obj]) / range;
-                }
+        size_t child = mu;
+        for (size_t i = 0; i < mu; ++i) {
+            if (!kept[i]) {
+                while (!kept[child]) ++child;
+                std::swap(pop[i], next_pop[child - mu]);
+                ranks[i] = ranks[child];
+                crowding[i] = crowding[child];
+                ++child;
             }
+            pop[i].rank = ranks[i];
+            pop[i].crowding_distance = crowding[i];
         }
     }
 
     // Турнирный отбор с учётом ранга и crowding distance
-    Individual tournamentSelection(const std::vector<Individual>& pop) {
+    size_t tournamentSelection(const std::vector<Individual>& pop, std::mt19937& rng) const {
         std::uniform_int_distribution<> dist(0, pop.size() - 1);
-        int idx1 = dist(gen), idx2 = dist(gen);
-        if (pop[idx1].rank < pop[idx2].rank) return pop[idx1];
-        if (pop[idx2].rank < pop[idx1].rank) return pop[idx2];
-        return pop[idx1].crowding_distance > pop[idx2].crowding_distance ? pop[idx1] : pop[idx2];
+        size_t idx1 = dist(rng), idx2 = dist(rng);
+        if (pop[idx1].rank < pop[idx2].rank) return idx1;
+        if (pop[idx2].rank < pop[idx1].rank) return idx2;
+        return pop[idx1].crowding_distance > pop[idx2].crowding_distance ? idx1 : idx2;
+    }
+
+    // Границы части chunk из count элементов при делении на worker_gens.size() частей
+    std::pair<size_t, size_t> chunkRange(size_t chunk, size_t count) const {
+        size_t parts = worker_gens.size();
+        return { count * chunk / parts, count * (chunk + 1) / parts };
     }
 
 public:
-    GeneticAlgorithm() {
-        std::random_device rd;
-        gen.seed(rd());
-        for (int i = 0; i < Config::POPULATION_SIZE; ++i) {
-            Schedule s;
-            s.initialize(gen);
-            population.push_back(s);
+    GeneticAlgorithm() : GeneticAlgorithm(std::random_device{}()) {}
+
+    explicit GeneticAlgorithm(unsigned seed, size_t num_threads = Config::NUM_THREADS)
+        : GeneticAlgorithm(Instance::defaultInstance(), seed, num_threads) {}
+
+    // num_threads = 0 — по числу аппаратных потоков; instance должен жить дольше алгоритма
+    GeneticAlgorithm(const Instance& instance, unsigned seed, size_t num_threads = Config::NUM_THREADS)
+        : instance(instance), pool(num_threads) {
+        std::seed_seq master{ seed, 0u };
+        gen.seed(master);
+        for (size_t w = 0; w < pool.size(); ++w) {
+            std::seed_seq stream{ seed, static_cast<unsigned>(w + 1) };
+            worker_gens.emplace_back(stream);
         }
+        repairers.resize(worker_gens.size());
+        worker_times.resize(worker_gens.size());
+
+        population.assign(Config::POPULATION_SIZE, Schedule(instance));
+        pool.parallelFor(worker_gens.size(), [&](size_t chunk) {
+            auto range = chunkRange(chunk, population.size());
+            GreedyInitializer greedy;
+            for (size_t i = range.first; i < range.second; ++i) {
+                if (Config::INIT_STRATEGY == InitStrategy::Greedy) greedy.initialize(population[i], worker_gens[chunk]);
+                else population[i].initialize(worker_gens[chunk]);
+                population[i].fitness();
+            }
+        });
     }
 
     Schedule crossover(const Schedule& p1, const Schedule& p2) {
-        Schedule child;
-        if (p1.lessons.empty() || p2.lessons.empty()) return child;
+        return crossover(p1, p2, gen);
+    }
+
+    Schedule crossover(const Schedule& p1, const Schedule& p2, std::mt19937& rng) const {
+        Schedule child(p1.instance());
+        crossover(p1, p2, child, rng);
+        return child;
+    }
+
+    // Одноточечное скрещивание в уже существующего потомка: его ёмкость переиспользуется
+    void crossover(const Schedule& p1, const Schedule& p2, Schedule& child, std::mt19937& rng) const {
+        child.invalidateFitness();
+        child.lessons.clear();
+        if (p1.lessons.empty() || p2.lessons.empty()) return;
 
         std::uniform_int_distribution<> dist(0, (int)p1.lessons.size() - 1);
-        int point = dist(gen);
+        int point = dist(rng);
+        // Гены — POD-структуры, поэтому обе половины копируются блоком
         child.lessons.reserve(p1.lessons.size());
-        for (size_t i = 0; i < p1.lessons.size(); ++i)
-            child.lessons.push_back(i < point ? p1.lessons[i] : p2.lessons[i]);
-        return child;
+        child.lessons.assign(p1.lessons.begin(), p1.lessons.begin() + point);
+        child.lessons.insert(child.lessons.end(), p2.lessons.begin() + point, p2.lessons.end());
     }
 
-    std::vector<Schedule> run() {
-        std::vector<Individual> pop;
+    // Начать эволюцию заново с начальной популяции
+    void reset() {
+        pop.clear();
         for (auto& s : population) pop.emplace_back(s);
+        pareto_archive.clear();
+        for (auto& ind : pop) pareto_archive.offer(ind.schedule, ind.objectives);
+        evaluation_count = static_cast<long long>(pop.size());
+        // Ранги текущей популяции: дальше сортировка выполняется один раз за поколение
+        nonDominatedSort(pop);
+        generation_count = 0;
+    }
 
-        for (int gen_num = 0; gen_num < Config::MAX_GENERATIONS; ++gen_num) {
-            // Шаг 1: Сортировка по не доминированию
-            nonDominatedSort(pop);
+    // Затравка: первые расписания начальной популяции заменяются seeds
+    // (например, расписаниями прошлого семестра); действует со следующего reset
+    void seed(const std::vector<Schedule>& seeds) {
+        const size_t genes = static_cast<size_t>(instance.lessonsPerSchedule());
+        for (size_t i = 0; i < seeds.size() && i < population.size(); ++i) {
+            if (seeds[i].lessons.size() != genes) throw std::runtime_error("затравочное расписание не соответствует экземпляру задачи");
+            population[i].lessons = seeds[i].lessons;
+            population[i].invalidateFitness();
+            population[i].fitness();
+        }
+    }
 
-            // Шаг 2: Создание новой популяции
-            std::vector<Individual> new_pop;
-            auto best_it = std::min_element(pop.begin(), pop.end(),
-                [](const Individual& a, const Individual& b) { return a.rank < b.rank; });
-            new_pop.push_back(*best_it); // Элитизм
-
-            while (new_pop.size() < Config::POPULATION_SIZE) {
-                Individual parent1 = tournamentSelection(pop);
-                Individual parent2 = tournamentSelection(pop);
-                Schedule child = crossover(parent1.schedule, parent2.schedule);
-                if (child.lessons.empty()) {
-                    child.initialize(gen);
-                }
-                child.mutate(gen);
-                new_pop.emplace_back(child);
+    // Сохранить популяцию, архив, состояния ГСЧ и счётчики в двоичный снимок
+    void saveCheckpoint(const std::string& path) {
+        if (pop.empty()) reset();
+        Checkpoint::State state;
+        for (const auto& ind : pop) {
+            state.population.push_back(&ind.schedule);
+            state.population_objectives.push_back(ind.objectives);
+        }
+        for (size_t i = 0; i < pareto_archive.size(); ++i) {
+            state.archive.push_back(&pareto_archive.schedule(i));
+            state.archive_objectives.push_back(pareto_archive.objectives(i));
+        }
+        state.rngs.push_back(&gen);
+        for (const auto& rng : worker_gens) state.rngs.push_back(&rng);
+        state.generation = generation_count;
+        state.evaluations = evaluation_count;
+        Checkpoint::save(path, instance, state);
+    }
+
+    // Продолжить прогон с сохранённого снимка того же экземпляра задачи.
+    // При другом числе потоков ГСЧ частей популяции заново засеваются главным ГСЧ.
+    void loadCheckpoint(const std::string& path) {
+        Checkpoint::Snapshot snapshot(path, instance);
+        if (snapshot.populationSize() == 0) throw std::runtime_error("в снимке нет популяции: " + path);
+        pop.resize(snapshot.populationSize());
+        for (size_t i = 0; i < pop.size(); ++i) {
+            pop[i].schedule = Schedule(instance);
+            snapshot.population(i, pop[i].schedule);
+            pop[i].objectives = pop[i].schedule.fitness();
+        }
+        next_pop.clear();
+        pareto_archive.clear();
+        Schedule member(instance);
+        for (size_t i = 0; i < snapshot.archiveSize(); ++i) {
+            snapshot.archive(i, member);
+            pareto_archive.offer(member, member.fitness());
+        }
+
+        std::vector<std::mt19937> rngs = snapshot.rngs();
+        if (!rngs.empty()) gen = rngs[0];
+        if (rngs.size() == worker_gens.size() + 1) {
+            std::copy(rngs.begin() + 1, rngs.end(), worker_gens.begin());
+        }
+        else {
+            for (auto& rng : worker_gens) {
+                std::seed_seq stream{ gen(), gen() };
+                rng.seed(stream);
             }
+        }
+        generation_count = static_cast<int>(snapshot.header().generation);
+        evaluation_count = snapshot.header().evaluations;
+        nonDominatedSort(pop);
+    }
 
-            pop = std::move(new_pop);
+    // Одно поколение: отбор, скрещивание, мутация, оценка и отбор выживших.
+    // При Survival::SteadyState поколение — одна порция из STEADY_STATE_OFFSPRING потомков.
+    void evolve() {
+        if (pop.empty()) reset();
+        const auto start = PhaseTimes::Clock::now();
+        const unsigned long long allocations_before = AllocCounter::count();
+        const long long moves_before = moveEvaluations();
+        stats.phases.clear();
 
-            // Печать лучшего фронта
-            std::cout << "Generation " << gen_num << ": Pareto front size = ";
-            nonDominatedSort(pop);
-            int front0_size = 0;
-            for (auto& ind : pop) if (ind.rank == 0) front0_size++;
-            std::cout << front0_size << std::endl;
-
-            // Проверка на расписание без конфликтов (конфликты = 0)
-            bool no_conflicts = false;
-            for (auto& ind : pop) {
-                auto fitness = ind.schedule.calculateFitness();
-                if (fitness[0] < 0.1) {
-                    no_conflicts = true;
-                    break;
+        // Первое поколение: буфер заполняется копиями, дальше слоты только перезаписываются
+        const size_t num_children = offspringCount();
+        const size_t first = survival == Survival::Generational ? 1 : 0;
+        if (next_pop.size() != first + num_children) next_pop.assign(pop.begin(), pop.begin() + first + num_children);
+
+        // Элитизм поколенческой схемы: лучшая по рангу особь копируется в первый слот
+        if (survival == Survival::Generational) {
+            size_t best = 0;
+            for (size_t i = 1; i < pop.size(); ++i)
+                if (pop[i].rank < pop[best].rank) best = i;
+            next_pop[0] = pop[best];
+        }
+
+        // Потомки создаются, мутируют, ремонтируются и оцениваются параллельно, каждая часть — своим ГСЧ
+        pool.parallelFor(worker_gens.size(), [&](size_t chunk) {
+            std::mt19937& rng = worker_gens[chunk];
+            PhaseTimes& times = worker_times[chunk].times;
+            times.clear();
+            std::uniform_real_distribution<> prob(0, 1);
+            auto range = chunkRange(chunk, num_children);
+            for (size_t i = range.first; i < range.second; ++i) {
+                auto t = PhaseTimes::Clock::now();
+                size_t parent1 = tournamentSelection(pop, rng);
+                size_t parent2 = tournamentSelection(pop, rng);
+                t = times.lap(Phase::Selection, t);
+                Individual& child = next_pop[first + i];
+                crossover(pop[parent1].schedule, pop[parent2].schedule, child.schedule, rng);
+                if (child.schedule.lessons.empty()) {
+                    child.schedule.initialize(rng);
+                }
+                t = times.lap(Phase::Crossover, t);
+                child.schedule.mutate(rng);
+                t = times.lap(Phase::Mutation, t);
+                if (prob(rng) < Config::REPAIR_RATE) {
+                    repairers[chunk].repair(child.schedule, rng);
+                    t = times.lap(Phase::Repair, t);
                 }
+                child.objectives = child.schedule.fitness();
+                times.lap(Phase::Evaluation, t);
             }
-            if (no_conflicts) break;
+        });
+        for (const auto& w : worker_times) stats.phases += w.times;
+
+        // Архив пополняется последовательно в порядке слотов: результат не зависит от потоков
+        auto archive_start = PhaseTimes::Clock::now();
+        for (size_t i = first; i < next_pop.size(); ++i) pareto_archive.offer(next_pop[i].schedule, next_pop[i].objectives);
+        stats.phases.lap(Phase::Archive, archive_start);
+
+        // Ранги новой популяции нужны и для печати, и для следующего поколения
+        if (survival == Survival::Generational) {
+            pop.swap(next_pop);
+            nonDominatedSort(pop);
         }
+        else {
+            environmentalSelection();
+        }
+        generation_count++;
+
+        stats.generation = generation_count;
+        stats.evaluations = static_cast<long long>(num_children);
+        evaluation_count += stats.evaluations;
+        stats.move_evaluations = moveEvaluations() - moves_before;
+        summarizeObjectives();
+        stats.allocations = AllocCounter::count() - allocations_before;
+        stats.seconds = std::chrono::duration<double>(PhaseTimes::Clock::now() - start).count();
+        trace.write(stats);
+    }
+
+    // Сводка последнего поколения: время фаз, счётчики, лучшие и медианные цели
+    const GenerationStats& lastStats() const { return stats; }
+
+    // Писать сводку каждого поколения в файл JSON Lines; пустой путь — выключить
+    void setTrace(const std::string& path) {
+        trace.close();
+        if (!path.empty()) trace.open(path);
+    }
+
+    // Печать прогресса run() в консоль
+    void setConsoleOutput(bool enabled) { console_output = enabled; }
+
+    // Схема отбора выживших; действует со следующего поколения
+    void setSurvival(Survival s) {
+        survival = s;
+        next_pop.clear();
+    }
+
+    int generation() const { return generation_count; }
+    long long evaluations() const { return evaluation_count; }
+
+    size_t populationSize() const { return pop.size(); }
+    const Schedule::Fitness& objectives(size_t i) const { return pop[i].objectives; }
+
+    size_t frontSize() const {
+        size_t front0_size = 0;
+        for (auto& ind : pop) if (ind.rank == 0) front0_size++;
+        return front0_size;
+    }
+
+    // Есть ли расписание без конфликтов (конфликты = 0)
+    bool hasConflictFree() const {
+        for (auto& ind : pop) {
+            if (ind.objectives[0] < 0.1) return true;
+        }
+        return false;
+    }
+
+    // Внешний архив недоминируемых расписаний за весь прогон
+    const ParetoArchive& archive() const { return pareto_archive; }
 
-        // Возвращаем Парето-фронт
+    // Недоминируемые особи текущей популяции
+    std::vector<Schedule> paretoFront() const {
         std::vector<Schedule> pareto_front;
         for (auto& ind : pop) {
             if (ind.rank == 0) pareto_front.push_back(ind.schedule);
         }
         return pareto_front;
     }
+
+    // Мигранты: до count особей фронта 0 с наибольшим crowding distance
+    std::vector<Schedule> emigrants(size_t count) const {
+        std::vector<int> front;
+        for (size_t i = 0; i < pop.size(); ++i)
+            if (pop[i].rank == 0) front.push_back(static_cast<int>(i));
+        count = std::min(count, front.size());
+        std::partial_sort(front.begin(), front.begin() + count, front.end(), [&](int a, int b) {
+            return pop[a].crowding_distance > pop[b].crowding_distance;
+        });
+        std::vector<Schedule> result;
+        for (size_t i = 0; i < count; ++i) result.push_back(pop[front[i]].schedule);
+        return result;
+    }
+
+    // Заменить худшие особи (старший ранг, наименьший crowding distance) мигрантами
+    void immigrate(const std::vector<Schedule>& migrants) {
+        if (pop.empty()) reset();
+        std::vector<int> order(pop.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            if (pop[a].rank != pop[b].rank) return pop[a].rank > pop[b].rank;
+            return pop[a].crowding_distance < pop[b].crowding_distance;
+        });
+        for (size_t i = 0; i < migrants.size() && i < order.size(); ++i) {
+            pop[order[i]] = Individual(migrants[i]);
+        }
+        nonDominatedSort(pop);
+    }
+
+    // Прогон с бюджетом: до срока, числа оценок или поколений, до застоя или отмены.
+    // Ограничения проверяются между поколениями, поэтому срок может быть превышен
+    // на длительность одного поколения. Возвращает архив на момент остановки.
+    // Застой: за stall_window поколений ни минимум какой-либо цели в архиве,
+    // ни минимум свёртки Schedule::weightedFitness не улучшились
+    // относительно больше чем на stall_tolerance.
+    // С resume прогон продолжается с текущего состояния (например, после
+    // loadCheckpoint), а лимит поколений отсчитывается от его счётчика.
+    SolveResult solve(const SolveOptions& options) {
+        const auto start = PhaseTimes::Clock::now();
+        auto elapsed = [&] { return std::chrono::duration<double>(PhaseTimes::Clock::now() - start).count(); };
+        if (!options.resume || pop.empty()) reset();
+
+        SolveResult result;
+        Schedule::Fitness best_seen = archiveMinima();
+        double best_weighted = archiveBestWeighted();
+        int stalled = 0;
+        auto improved = [&](double now, double before) {
+            return now < before - options.stall_tolerance * before;
+        };
+
+        for (;;) {
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed)) { result.reason = StopReason::Cancelled; break; }
+            if (options.max_generations > 0 && generation_count >= options.max_generations) { result.reason = StopReason::Generations; break; }
+            if (options.time_limit > 0 && elapsed() >= options.time_limit) { result.reason = StopReason::TimeLimit; break; }
+            if (options.max_evaluations > 0 && evaluation_count >= options.max_evaluations) { result.reason = StopReason::EvaluationBudget; break; }
+
+            evolve();
+
+            Schedule::Fitness minima = archiveMinima();
+            double weighted = archiveBestWeighted();
+            bool progress = improved(weighted, best_weighted);
+            for (size_t k = 0; k < minima.size(); ++k) progress = progress || improved(minima[k], best_seen[k]);
+            // Опорные значения — последнее заметное улучшение, а не прошлое поколение:
+            // иначе медленный, но устойчивый рост за окно считался бы застоем
+            if (progress) {
+                best_seen = minima;
+                best_weighted = weighted;
+            }
+            stalled = progress ? 0 : stalled + 1;
+
+            if (options.on_progress && options.progress_interval > 0 && generation_count % options.progress_interval == 0) {
+                options.on_progress({ generation_count, elapsed(), evaluation_count, stalled, pareto_archive, stats });
+            }
+            if (!options.checkpoint_path.empty() && options.checkpoint_interval > 0 &&
+                generation_count % options.checkpoint_interval == 0) {
+                saveCheckpoint(options.checkpoint_path);
+            }
+            if (options.stop_when_conflict_free && minima[0] == 0.0) { result.reason = StopReason::ConflictFree; break; }
+            if (options.stall_window > 0 && stalled >= options.stall_window) { result.reason = StopReason::Stagnation; break; }
+        }
+
+        if (!options.checkpoint_path.empty()) saveCheckpoint(options.checkpoint_path);
+        result.front = pareto_archive.schedules();
+        result.generations = generation_count;
+        result.evaluations = evaluation_count;
+        result.seconds = elapsed();
+        return result;
+    }
+
+    std::vector<Schedule> run() {
+        reset();
+
+        for (int gen_num = 0; gen_num < Config::MAX_GENERATIONS; ++gen_num) {
+            evolve();
+
+            // Печать лучшего фронта; поток сбрасывается один раз в конце прогона
+            if (console_output) std::cout << "Generation " << gen_num << ": Pareto front size = " << frontSize() << '\n';
+
+            if (hasConflictFree()) break;
+        }
+        if (console_output) std::cout.flush();
+
+        // Возвращаем Парето-фронт архива: он включает решения всех поколений
+        return pareto_archive.schedules();
+    }
 };
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+#include "schedule.h"
+#include "occupancy.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+
+// Конструктивное начальное расписание в духе жадной раскраски графа.
+// Блоки (группа, день) обрабатываются от самых трудных к простым: крупные
+// группы первыми, так как им подходит меньше аудиторий; равные по трудности
+// блоки перемешиваются. Каждое занятие ставится в ту свободную для группы пару,
+// где найдутся свободный преподаватель с недобранной нагрузкой и подходящая
+// аудитория, с предпочтением дней преподавателя и без новых окон.
+// Небольшой случайный шум в оценке сохраняет разнообразие популяции.
+// Порядок генов тот же, что у Schedule::initialize: группа, день, номер пары.
+class GreedyInitializer {
+public:
+    void initialize(Schedule& s, std::mt19937& gen) {
+        const Instance& inst = s.instance();
+        schedule = &s;
+        s.invalidateFitness();
+        s.lessons.assign(inst.lessonsPerSchedule(), Lesson{});
+        grid.build(inst, {});
+
+        remaining.assign(inst.target_pairs.begin(), inst.target_pairs.end());
+        open.clear();
+        open_pos.assign(inst.num_teachers, -1);
+        for (int t = 0; t < inst.num_teachers; ++t) {
+            if (remaining[t] > 0 && inst.subjectCount(t) > 0) {
+                open_pos[t] = static_cast<int>(open.size());
+                open.push_back(t);
+            }
+        }
+        with_subjects.clear();
+        for (int t = 0; t < inst.num_teachers; ++t)
+            if (inst.subjectCount(t) > 0) with_subjects.push_back(t);
+
+        blocks.clear();
+        for (int g = 0; g < inst.num_groups; ++g)
+            for (int d = 0; d < inst.num_days; ++d) blocks.push_back({ g, d });
+        std::shuffle(blocks.begin(), blocks.end(), gen);
+        std::stable_sort(blocks.begin(), blocks.end(), [&](const Block& a, const Block& b) {
+            return inst.group_sizes[a.group] > inst.group_sizes[b.group];
+        });
+
+        const int per_day = inst.lessons_per_group_per_day;
+        for (const Block& b : blocks) {
+            for (int i = 0; i < per_day; ++i) {
+                size_t index = (static_cast<size_t>(b.group) * inst.num_days + b.day) * per_day + i;
+                s.lessons[index] = place(b.group, b.day, gen);
+                grid.add(s.lessons[index]);
+            }
+        }
+    }
+
+private:
+    struct Block {
+        int group;
+        int day;
+    };
+
+    // Штрафы при выборе ячейки: накладка преподавателя хуже всего
+    static constexpr double TEACHER_BUSY = 1000.0;
+    static constexpr double NO_ROOM = 100.0;
+    static constexpr double ROOM_MISMATCH = 10.0;
+    static constexpr double NEW_GAP = 5.0;
+    static constexpr double NOT_PREFERRED = 3.0;
+    static constexpr int TEACHER_SAMPLES = 8;   // Кандидатов в преподаватели на ячейку
+
+    Schedule* schedule = nullptr;
+    OccupancyGrid grid;
+    std::vector<int> remaining;     // Недобранная нагрузка преподавателя, пар
+    std::vector<int> open;          // Преподаватели с remaining > 0
+    std::vector<int> open_pos;      // Позиция в open, -1 — нет
+    std::vector<int> with_subjects; // Запасной список, когда нагрузка у всех добрана
+    std::vector<Block> blocks;
+
+    // Лучшее занятие группы в день day
+    Lesson place(int group, int day, std::mt19937& gen) {
+        const Instance& inst = schedule->instance();
+        std::uniform_real_distribution<> noise(0, 1);
+        std::uniform_int_distribution<> type_dist(0, 2);
+        const uint64_t mask = grid.groupDayMask(group, day);
+        const int gaps_before = Bits::gaps(mask);
+
+        Lesson best;
+        double best_cost = 0.0;
+        bool found = false;
+        for (int slot = 0; slot < inst.slots_per_day; ++slot) {
+            if (grid.groupCount(group, day, slot) > 0) continue;
+
+            Lesson l;
+            l.group = static_cast<uint16_t>(group);
+            l.day = static_cast<uint8_t>(day);
+            l.slot = static_cast<uint8_t>(slot);
+            l.type = static_cast<LessonType>(type_dist(gen));
+            double cost = NEW_GAP * (Bits::gaps(mask | (uint64_t(1) << slot)) - gaps_before) + noise(gen);
+
+            int teacher = pickTeacher(day, slot, gen);
+            l.teacher = static_cast<uint16_t>(teacher);
+            if (grid.teacherCount(teacher, day, slot) > 0) cost += TEACHER_BUSY;
+            if (!((inst.preferred_mask[teacher] >> day) & 1)) cost += NOT_PREFERRED;
+
+            int room = pickRoom(l);
+            if (room < 0) {
+                cost += NO_ROOM;
+                room = std::uniform_int_distribution<>(0, inst.num_rooms - 1)(gen);
+            }
+            l.room = static_cast<uint16_t>(room);
+            if (schedule->capacityConflict(l) || schedule->typeConflict(l)) cost += ROOM_MISMATCH;
+
+            if (!found || cost < best_cost) {
+                best = l;
+                best_cost = cost;
+                found = true;
+            }
+        }
+        // Все пары дня заняты группой: ставим в случайную, накладку уберёт ремонт
+        if (!found) {
+            best.group = static_cast<uint16_t>(group);
+            best.day = static_cast<uint8_t>(day);
+            best.slot = static_cast<uint8_t>(std::uniform_int_distribution<>(0, inst.slots_per_day - 1)(gen));
+            best.type = static_cast<LessonType>(type_dist(gen));
+            best.teacher = static_cast<uint16_t>(pickTeacher(day, best.slot, gen));
+            best.room = static_cast<uint16_t>(std::uniform_int_distribution<>(0, inst.num_rooms - 1)(gen));
+        }
+
+        int k = std::uniform_int_distribution<>(0, inst.subjectCount(best.teacher) - 1)(gen);
+        best.subject = static_cast<uint16_t>(inst.subjectAt(best.teacher, k));
+        consume(best.teacher);
+        return best;
+    }
+
+    // Из нескольких случайных преподавателей с недобранной нагрузкой выбирается
+    // свободный в ячейке, затем с подходящим днём, затем с наибольшим остатком
+    int pickTeacher(int day, int slot, std::mt19937& gen) const {
+        const Instance& inst = schedule->instance();
+        const std::vector<int>& pool = open.empty() ? with_subjects : open;
+        std::uniform_int_distribution<size_t> dist(0, pool.size() - 1);
+        int best = -1;
+        long long best_key = 0;
+        for (int k = 0; k < TEACHER_SAMPLES; ++k) {
+            int t = pool[dist(gen)];
+            long long key = (grid.teacherCount(t, day, slot) == 0 ? 1LL << 40 : 0) +
+                (((inst.preferred_mask[t] >> day) & 1) ? 1LL << 32 : 0) + remaining[t];
+            if (best < 0 || key > best_key) {
+                best = t;
+                best_key = key;
+            }
+        }
+        return best;
+    }
+
+    // Наименьшая свободная аудитория нужного класса и вместимости, иначе любая свободная того же класса
+    int pickRoom(const Lesson& l) const {
+        const Instance& inst = schedule->instance();
+        const auto& typed = inst.rooms_by_type[static_cast<int>(requiredRoomType(l.type))];
+        const int size = inst.group_sizes[l.group];
+        auto fits = std::partition_point(typed.begin(), typed.end(), [&](int r) {
+            return inst.room_capacities[r] < size;
+        });
+        for (auto it = fits; it != typed.end(); ++it)
+            if (grid.roomCount(*it, l.day, l.slot) == 0) return *it;
+        for (auto it = fits; it != typed.begin();)
+            if (grid.roomCount(*--it, l.day, l.slot) == 0) return *it;
+        return -1;
+    }
+
+    void consume(int teacher) {
+        if (--remaining[teacher] > 0 || open_pos[teacher] < 0) return;
+        int pos = open_pos[teacher];
+        open[pos] = open.back();
+        open_pos[open[pos]] = pos;
+        open.pop_back();
+        open_pos[teacher] = -1;
+    }
+};
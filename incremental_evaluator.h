@@ -0,0 +1,178 @@
+#pragma once
+#include "schedule.h"
+#include "occupancy.h"
+#include <vector>
+#include <random>
+#include <cstdlib>
+
+// Инкрементальная оценка расписания. Хранит индекс занятости, нагрузку
+// преподавателей и ненормированные суммы штрафов, поэтому перенос одного
+// занятия пересчитывается за O(1) вместо полного calculateFitness:
+// цели линейны по суммам, и множители нормировки считаются один раз при attach().
+// Основа для дешёвой мутации, локального поиска и ремонта расписаний.
+class IncrementalEvaluator {
+public:
+    IncrementalEvaluator() = default;
+    explicit IncrementalEvaluator(Schedule& s) { attach(s); }
+
+    // Привязка к расписанию и полное построение состояния за O(L)
+    void attach(Schedule& s) {
+        schedule = &s;
+        const Instance& inst = s.instance();
+        history.clear();
+        reserve(s.lessons.size()); // mutate() делает не больше хода на занятие
+        grid.build(inst, s.lessons);
+        load.assign(inst.num_teachers, 0);
+        gaps = 0;
+        sum_squares = 0;
+        capacity_conflicts = 0;
+        type_conflicts = 0;
+        pref_conflicts = 0;
+        load_deviation = 0;
+        // Ходы не меняют число занятий, поэтому множители нормировки постоянны до следующего attach()
+        Schedule::Fitness ones;
+        ones.fill(1.0);
+        scale = s.normalizeFitness(ones, s.lessons.size());
+
+        for (const auto& l : s.lessons) {
+            load[l.teacher]++;
+            capacity_conflicts += s.capacityConflict(l);
+            type_conflicts += s.typeConflict(l);
+            pref_conflicts += s.preferenceConflict(l);
+        }
+        const auto& target = inst.target_pairs;
+        for (int t = 0; t < inst.num_teachers; ++t)
+            load_deviation += std::abs(load[t] - target[t]);
+
+        // Баланс группы: sum (c - mean)^2 = sum c^2 - n^2 / D, где n не меняется при переносах
+        balance_offset = 0.0;
+        for (int g = 0; g < inst.num_groups; ++g) {
+            long long n = 0;
+            for (int d = 0; d < inst.num_days; ++d) {
+                long long c = grid.groupDayCount(g, d);
+                n += c;
+                sum_squares += c * c;
+                gaps += Bits::gaps(grid.groupDayMask(g, d));
+            }
+            balance_offset += static_cast<double>(n * n) / inst.num_days;
+        }
+    }
+
+    // Ненормированные суммы штрафов текущего состояния
+    Schedule::Fitness rawFitness() const {
+        return {
+            static_cast<double>(grid.hardConflicts()),
+            static_cast<double>(gaps),
+            static_cast<double>(sum_squares) - balance_offset,
+            static_cast<double>(capacity_conflicts),
+            static_cast<double>(type_conflicts),
+            static_cast<double>(load_deviation),
+            static_cast<double>(pref_conflicts)
+        };
+    }
+
+    // Нормированные цели текущего состояния за O(1)
+    Schedule::Fitness fitness() const {
+        Schedule::Fitness f = rawFitness();
+        for (size_t k = 0; k < f.size(); ++k) f[k] *= scale[k];
+        return f;
+    }
+
+    // Перенести занятие index в положение to; прежнее положение запоминается для undo()
+    void apply(size_t index, const Lesson& to) {
+        Lesson& l = schedule->lessons[index];
+        history.push_back({ index, l });
+        update(l, -1);
+        l = to;
+        update(l, +1);
+    }
+
+    // Журнал на moves ходов без выделений памяти до commit()
+    void reserve(size_t moves) { history.reserve(moves); }
+
+    // Откатить последний применённый ход
+    void undo() {
+        Move last = history.back();
+        history.pop_back();
+        Lesson& l = schedule->lessons[last.index];
+        update(l, -1);
+        l = last.previous;
+        update(l, +1);
+    }
+
+    // Изменение нормированных целей при переносе занятия, без применения хода;
+    // разность ненормированных сумм умножается на множители, полной нормировки нет
+    Schedule::Fitness moveDelta(size_t index, const Lesson& to) {
+        Schedule::Fitness before = rawFitness();
+        apply(index, to);
+        Schedule::Fitness after = rawFitness();
+        undo();
+        for (size_t k = 0; k < after.size(); ++k) after[k] = (after[k] - before[k]) * scale[k];
+        return after;
+    }
+
+    // Зафиксировать применённые ходы: журнал очищается, кэш целей расписания обновляется.
+    // Кэш нормируется делением, как в calculateFitness, чтобы цели совпадали до бита с полным расчётом
+    void commit() {
+        history.clear();
+        schedule->cached_fitness = schedule->normalizeFitness(rawFitness(), schedule->lessons.size());
+        schedule->fitness_valid = true;
+    }
+
+    // Мутация как в Schedule::mutate, но с инкрементальным пересчётом целей
+    void mutate(std::mt19937& gen) {
+        std::uniform_real_distribution<> prob(0, 1);
+        for (size_t i = 0; i < schedule->lessons.size(); ++i) {
+            if (prob(gen) < Config::MUTATION_RATE) {
+                apply(i, schedule->mutatedLesson(schedule->lessons[i], load, gen));
+            }
+        }
+        commit();
+    }
+
+    const OccupancyGrid& occupancy() const { return grid; }
+    int teacherLoad(int teacher) const { return load[teacher]; }
+    const std::vector<int>& teacherLoads() const { return load; }
+
+private:
+    struct Move {
+        size_t index;
+        Lesson previous;
+    };
+
+    Schedule* schedule = nullptr;
+    OccupancyGrid grid;
+    std::vector<int> load;
+    std::vector<Move> history;
+    Schedule::Fitness scale{};      // Множители нормировки каждой цели
+
+    // Ненормированные суммы штрафов (конфликты хранятся в grid)
+    long long gaps = 0;
+    long long sum_squares = 0;
+    double balance_offset = 0.0;
+    long long capacity_conflicts = 0;
+    long long type_conflicts = 0;
+    long long pref_conflicts = 0;
+    long long load_deviation = 0;
+
+    // Добавить (sign = +1) или убрать (sign = -1) вклад занятия
+    void update(const Lesson& l, int sign) {
+        uint64_t mask_before = grid.groupDayMask(l.group, l.day);
+        long long count_before = grid.groupDayCount(l.group, l.day);
+        if (sign > 0) grid.add(l);
+        else grid.remove(l);
+        long long count_after = grid.groupDayCount(l.group, l.day);
+
+        gaps += Bits::gaps(grid.groupDayMask(l.group, l.day)) - Bits::gaps(mask_before);
+        sum_squares += count_after * count_after - count_before * count_before;
+
+        int target = schedule->instance().target_pairs[l.teacher];
+        load_deviation -= std::abs(load[l.teacher] - target);
+        load[l.teacher] += sign;
+        load_deviation += std::abs(load[l.teacher] - target);
+
+        capacity_conflicts += sign * schedule->capacityConflict(l);
+        type_conflicts += sign * schedule->typeConflict(l);
+        pref_conflicts += sign * schedule->preferenceConflict(l);
+    }
+};
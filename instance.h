@@ -0,0 +1,215 @@
+#pragma once
+#include "config.h"
+#include "json.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// Экземпляр задачи: размеры, справочники и плотные таблицы для горячих циклов.
+// Загружается из JSON-файла или строится из тестовых данных Config.
+// После заполнения исходных полей вызывается finalize(): он проверяет данные
+// и вычисляет таблицы, поэтому в оценке и мутации нет поиска по словарям.
+// Экземпляр должен жить дольше всех расписаний, построенных по нему.
+struct Instance {
+    // === Размеры ===
+    int num_groups = 0;
+    int num_teachers = 0;
+    int num_rooms = 0;
+    int num_subjects = 0;
+    int num_days = 0;
+    int slots_per_day = 0;
+    int lessons_per_group_per_day = 0;
+
+    // === Исходные данные ===
+    std::vector<std::string> days;
+    std::vector<std::string> groups;
+    std::vector<std::string> teachers;
+    std::vector<std::string> subjects;
+    std::vector<std::string> rooms;
+    std::vector<int> group_sizes;
+    std::vector<int> room_capacities;
+    std::vector<RoomType> room_types;
+    std::vector<std::pair<int, int>> teacher_subject_pairs; // (преподаватель, предмет)
+    std::vector<int> teacher_semester_hours;
+    std::vector<std::vector<int>> teacher_preferred_days;   // Пустой список — без предпочтений
+
+    // === Предвычисленные таблицы (finalize) ===
+    std::vector<int> target_pairs;          // Целевое число пар преподавателя
+    std::vector<uint64_t> preferred_mask;   // Бит d — день d подходит преподавателю
+    std::vector<int> subject_offsets;       // teacher_subjects[subject_offsets[t] .. subject_offsets[t + 1])
+    std::vector<int> teacher_subjects;
+    std::vector<int> pref_offsets;          // pref_days[pref_offsets[t] .. pref_offsets[t + 1])
+    std::vector<int> pref_days;
+    std::vector<std::vector<int>> rooms_by_type; // Аудитории каждого класса по возрастанию вместимости
+    std::vector<int> room_type_codes;       // Класс аудитории числом: для векторной выборки в FitnessKernel
+    double max_gaps = 0.0;
+    double max_balance = 0.0;
+
+    int lessonsPerSchedule() const { return num_groups * num_days * lessons_per_group_per_day; }
+    bool hasPreferences(int teacher) const { return pref_offsets[teacher + 1] > pref_offsets[teacher]; }
+    int subjectCount(int teacher) const { return subject_offsets[teacher + 1] - subject_offsets[teacher]; }
+    int subjectAt(int teacher, int k) const { return teacher_subjects[subject_offsets[teacher] + k]; }
+    int preferredDayCount(int teacher) const { return pref_offsets[teacher + 1] - pref_offsets[teacher]; }
+    int preferredDayAt(int teacher, int k) const { return pref_days[pref_offsets[teacher] + k]; }
+
+    // Проверка данных и построение таблиц; при ошибке бросает std::runtime_error
+    void finalize() {
+        num_days = static_cast<int>(days.size());
+        num_groups = static_cast<int>(groups.size());
+        num_teachers = static_cast<int>(teachers.size());
+        num_subjects = static_cast<int>(subjects.size());
+        num_rooms = static_cast<int>(rooms.size());
+
+        check(num_days > 0 && num_days <= 64, "число дней должно быть от 1 до 64");
+        check(slots_per_day > 0 && slots_per_day <= 64, "число пар в день должно быть от 1 до 64");
+        check(lessons_per_group_per_day >= 0, "отрицательное число пар группы в день");
+        check(num_groups > 0 && num_groups <= 65535, "число групп должно быть от 1 до 65535");
+        check(num_teachers > 0 && num_teachers <= 65535, "число преподавателей должно быть от 1 до 65535");
+        check(num_rooms > 0 && num_rooms <= 65535, "число аудиторий должно быть от 1 до 65535");
+        check(num_subjects <= 65535, "число предметов больше 65535");
+        check(group_sizes.size() == groups.size(), "размеры групп не совпадают с числом групп");
+        check(room_capacities.size() == rooms.size(), "вместимости не совпадают с числом аудиторий");
+        check(room_types.size() == rooms.size(), "классы аудиторий не совпадают с числом аудиторий");
+        check(teacher_semester_hours.size() == teachers.size(), "часы не совпадают с числом преподавателей");
+        check(!teacher_subject_pairs.empty(), "нет допустимых пар преподаватель-предмет");
+        teacher_preferred_days.resize(num_teachers);
+
+        target_pairs.clear();
+        for (int h : teacher_semester_hours) {
+            target_pairs.push_back(static_cast<int>(std::round(h / 1.5)));
+        }
+
+        subject_offsets.assign(num_teachers + 1, 0);
+        for (const auto& p : teacher_subject_pairs) {
+            check(p.first >= 0 && p.first < num_teachers, "пара ссылается на несуществующего преподавателя");
+            check(p.second >= 0 && p.second < num_subjects, "пара ссылается на несуществующий предмет");
+            subject_offsets[p.first + 1]++;
+        }
+        for (int t = 0; t < num_teachers; ++t) subject_offsets[t + 1] += subject_offsets[t];
+        teacher_subjects.assign(teacher_subject_pairs.size(), 0);
+        std::vector<int> fill(subject_offsets.begin(), subject_offsets.end() - 1);
+        for (const auto& p : teacher_subject_pairs) teacher_subjects[fill[p.first]++] = p.second;
+
+        preferred_mask.assign(num_teachers, 0);
+        pref_offsets.assign(1, 0);
+        pref_days.clear();
+        const uint64_t all_days = num_days == 64 ? ~uint64_t(0) : (uint64_t(1) << num_days) - 1;
+        for (int t = 0; t < num_teachers; ++t) {
+            for (int d : teacher_preferred_days[t]) {
+                check(d >= 0 && d < num_days, "предпочтительный день вне недели");
+                preferred_mask[t] |= uint64_t(1) << d;
+                pref_days.push_back(d);
+            }
+            if (teacher_preferred_days[t].empty()) preferred_mask[t] = all_days;
+            pref_offsets.push_back(static_cast<int>(pref_days.size()));
+        }
+
+        room_type_codes.clear();
+        for (RoomType t : room_types) room_type_codes.push_back(static_cast<int>(t));
+        rooms_by_type.assign(3, {});
+        for (int r = 0; r < num_rooms; ++r) rooms_by_type[static_cast<int>(room_types[r])].push_back(r);
+        for (auto& list : rooms_by_type) {
+            std::stable_sort(list.begin(), list.end(), [&](int a, int b) { return room_capacities[a] < room_capacities[b]; });
+        }
+
+        max_gaps = num_groups * num_days * (slots_per_day - 1);
+        max_balance = num_groups * (std::pow(lessons_per_group_per_day * num_days - lessons_per_group_per_day, 2) +
+            (num_days - 1) * std::pow(lessons_per_group_per_day, 2));
+    }
+
+    // Тестовый экземпляр из Config
+    static Instance fromConfig() {
+        Instance inst;
+        inst.slots_per_day = Config::SLOTS_PER_DAY;
+        inst.lessons_per_group_per_day = Config::LESSONS_PER_GROUP_PER_DAY;
+        inst.days = Config::days;
+        inst.groups = Config::groups;
+        inst.teachers = Config::teachers;
+        inst.subjects = Config::subjects;
+        inst.rooms = Config::rooms;
+        inst.group_sizes = Config::group_sizes;
+        inst.room_capacities = Config::room_capacities;
+        inst.room_types = Config::room_types;
+        inst.teacher_subject_pairs = Config::teacher_subject_pairs;
+        inst.teacher_semester_hours = Config::teacher_semester_hours;
+        inst.teacher_preferred_days.resize(Config::teachers.size());
+        for (const auto& p : Config::teacher_preferred_days) inst.teacher_preferred_days[p.first] = p.second;
+        inst.finalize();
+        return inst;
+    }
+
+    // Экземпляр по умолчанию для расписаний, созданных без явного экземпляра
+    static const Instance& defaultInstance() {
+        static const Instance inst = fromConfig();
+        return inst;
+    }
+
+    // Загрузка из JSON-файла:
+    // {
+    //   "days": ["Пн", ...], "slots_per_day": 6, "lessons_per_group_per_day": 4,
+    //   "subjects": ["Математика", ...],
+    //   "groups": [{ "name": "КИ22-03Б", "size": 25 }, ...],
+    //   "rooms": [{ "name": "101", "capacity": 30, "type": "lecture" }, ...],
+    //   "teachers": [{ "name": "Иванов", "hours": 9, "subjects": [0, 1], "preferred_days": [0, 1] }, ...]
+    // }
+    // Тип аудитории: "lecture" / "computer" / "lab" или русское название класса.
+    static Instance load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("не удалось открыть файл задачи: " + path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        return fromJson(Json::parse(buffer.str()));
+    }
+
+    static Instance fromJson(const Json& root) {
+        Instance inst;
+        for (const auto& d : root["days"].array()) inst.days.push_back(d.asString());
+        inst.slots_per_day = root["slots_per_day"].asInt();
+        inst.lessons_per_group_per_day = root["lessons_per_group_per_day"].asInt();
+        for (const auto& s : root["subjects"].array()) inst.subjects.push_back(s.asString());
+
+        for (const auto& g : root["groups"].array()) {
+            inst.groups.push_back(g["name"].asString());
+            inst.group_sizes.push_back(g["size"].asInt());
+        }
+
+        for (const auto& r : root["rooms"].array()) {
+            inst.rooms.push_back(r["name"].asString());
+            inst.room_capacities.push_back(r["capacity"].asInt());
+            inst.room_types.push_back(parseRoomType(r["type"].asString()));
+        }
+
+        const auto& teachers = root["teachers"].array();
+        inst.teacher_preferred_days.resize(teachers.size());
+        for (size_t t = 0; t < teachers.size(); ++t) {
+            const Json& teacher = teachers[t];
+            inst.teachers.push_back(teacher["name"].asString());
+            inst.teacher_semester_hours.push_back(teacher["hours"].asInt());
+            for (const auto& s : teacher["subjects"].array())
+                inst.teacher_subject_pairs.emplace_back(static_cast<int>(t), s.asInt());
+            if (const Json* pref = teacher.find("preferred_days")) {
+                for (const auto& d : pref->array()) inst.teacher_preferred_days[t].push_back(d.asInt());
+            }
+        }
+
+        inst.finalize();
+        return inst;
+    }
+
+    static RoomType parseRoomType(const std::string& name) {
+        if (name == "lecture" || name == roomTypeName(RoomType::Lecture)) return RoomType::Lecture;
+        if (name == "computer" || name == roomTypeName(RoomType::Computer)) return RoomType::Computer;
+        if (name == "lab" || name == roomTypeName(RoomType::Lab)) return RoomType::Lab;
+        throw std::runtime_error("неизвестный класс аудитории: " + name);
+    }
+
+private:
+    static void check(bool condition, const char* message) {
+        if (!condition) throw std::runtime_error(std::string("некорректная задача: ") + message);
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include "instance.h"
+#include <random>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+// Синтетический экземпляр задачи заданного размера для бенчмарков.
+// Пропорции подобраны так, чтобы задача оставалась разрешимой: на каждую группу
+// приходится около 1.6 преподавателя и 0.8 аудитории, суммарная целевая нагрузка
+// преподавателей равна числу пар в неделю. Одно зерно — один и тот же экземпляр.
+inline Instance generateInstance(int num_groups, unsigned seed) {
+    std::mt19937 gen(seed);
+    Instance inst;
+    inst.days = Config::days;
+    inst.slots_per_day = Config::SLOTS_PER_DAY;
+    inst.lessons_per_group_per_day = Config::LESSONS_PER_GROUP_PER_DAY;
+
+    const int num_teachers = std::max(2, num_groups * 8 / 5);
+    const int num_rooms = std::max(3, num_groups * 4 / 5);
+    const int num_subjects = std::min(60, 5 + num_groups / 10);
+    const int total_pairs = num_groups * static_cast<int>(inst.days.size()) * inst.lessons_per_group_per_day;
+
+    std::uniform_int_distribution<> group_size(15, 35);
+    for (int g = 0; g < num_groups; ++g) {
+        inst.groups.push_back("Группа " + std::to_string(g + 1));
+        inst.group_sizes.push_back(group_size(gen));
+    }
+
+    for (int s = 0; s < num_subjects; ++s) {
+        inst.subjects.push_back("Предмет " + std::to_string(s + 1));
+    }
+
+    // Аудитории: классы по кругу, вместимость от 15 до 60
+    std::uniform_int_distribution<> capacity(15, 60);
+    for (int r = 0; r < num_rooms; ++r) {
+        inst.rooms.push_back(std::to_string(100 + r + 1));
+        inst.room_capacities.push_back(capacity(gen));
+        inst.room_types.push_back(static_cast<RoomType>(r % 3));
+    }
+
+    // Преподаватели: 1-3 предмета, нагрузка делит все пары недели поровну с разбросом
+    std::uniform_int_distribution<> subject_dist(0, num_subjects - 1);
+    std::uniform_int_distribution<> subject_count(1, 3);
+    std::uniform_real_distribution<> spread(0.7, 1.3);
+    std::uniform_real_distribution<> prob(0, 1);
+    const double mean_pairs = static_cast<double>(total_pairs) / num_teachers;
+    inst.teacher_preferred_days.resize(num_teachers);
+    for (int t = 0; t < num_teachers; ++t) {
+        inst.teachers.push_back("Преподаватель " + std::to_string(t + 1));
+        inst.teacher_semester_hours.push_back(static_cast<int>(std::round(mean_pairs * spread(gen) * 1.5)));
+
+        int first = subject_dist(gen);
+        int count = std::min(subject_count(gen), num_subjects);
+        for (int k = 0; k < count; ++k) {
+            inst.teacher_subject_pairs.emplace_back(t, (first + k) % num_subjects);
+        }
+
+        // 30% преподавателей без предпочтений, остальным подходит от 3 дней
+        if (prob(gen) < 0.3) continue;
+        for (int d = 0; d < static_cast<int>(inst.days.size()); ++d) {
+            if (prob(gen) < 0.7) inst.teacher_preferred_days[t].push_back(d);
+        }
+        while (inst.teacher_preferred_days[t].size() < 3) {
+            int d = std::uniform_int_distribution<>(0, static_cast<int>(inst.days.size()) - 1)(gen);
+            auto& days = inst.teacher_preferred_days[t];
+            if (std::find(days.begin(), days.end(), d) == days.end()) {
+                days.insert(std::upper_bound(days.begin(), days.end(), d), d);
+            }
+        }
+    }
+
+    inst.finalize();
+    return inst;
+}
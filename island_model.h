@@ -0,0 +1,108 @@
+#pragma once
+#include "genetic_algorithm.h"
+#include "pareto_archive.h"
+#include "thread_pool.h"
+#include <vector>
+#include <memory>
+#include <random>
+#include <string>
+#include <stdexcept>
+
+// Топология обмена особями между островами
+enum class MigrationTopology {
+    Ring,           // остров i отправляет мигрантов острову i + 1
+    FullyConnected  // каждый остров отправляет мигрантов всем остальным
+};
+
+// Островная модель: K независимых популяций эволюционируют в своих потоках
+// и каждые MIGRATION_INTERVAL поколений обмениваются лучшими недоминируемыми
+// особями. Острова синхронизируются на миграции, поэтому результат
+// воспроизводим при одинаковом зерне и числе островов.
+class IslandModel {
+public:
+    // num_islands = 0 — по числу аппаратных потоков; instance должен жить дольше модели
+    IslandModel(const Instance& instance, unsigned seed, size_t num_islands = Config::NUM_ISLANDS,
+        MigrationTopology topology = MigrationTopology::Ring)
+        : pool(num_islands), topology(topology) {
+        // Каждый остров однопоточный: параллельность даёт сам пул островов
+        std::seed_seq seq{ seed };
+        std::vector<unsigned> island_seeds(pool.size());
+        seq.generate(island_seeds.begin(), island_seeds.end());
+        for (unsigned s : island_seeds) {
+            islands.push_back(std::make_unique<GeneticAlgorithm>(instance, s, 1));
+        }
+    }
+
+    size_t size() const { return islands.size(); }
+
+    // Топология по имени: ring или full; иначе std::runtime_error
+    static MigrationTopology parseTopology(const std::string& name) {
+        if (name == "ring") return MigrationTopology::Ring;
+        if (name == "full") return MigrationTopology::FullyConnected;
+        throw std::runtime_error("неизвестная топология миграции: " + name + " (ring или full)");
+    }
+
+    // Эволюция до max_generations поколений каждого острова или, если stop_when_conflict_free,
+    // до расписания без конфликтов; возвращает общий Парето-фронт
+    std::vector<Schedule> run(int max_generations = Config::MAX_GENERATIONS, bool stop_when_conflict_free = true) {
+        for (auto& island : islands) island->reset();
+
+        int generation = 0;
+        while (generation < max_generations) {
+            int epoch = std::min(Config::MIGRATION_INTERVAL, max_generations - generation);
+            pool.parallelFor(islands.size(), [&](size_t i) {
+                for (int g = 0; g < epoch; ++g) {
+                    islands[i]->evolve();
+                    if (stop_when_conflict_free && islands[i]->hasConflictFree()) break;
+                }
+            });
+            generation += epoch;
+
+            bool no_conflicts = false;
+            for (auto& island : islands) no_conflicts = no_conflicts || island->hasConflictFree();
+            if (stop_when_conflict_free && no_conflicts) break;
+
+            migrate();
+        }
+
+        return mergedFront();
+    }
+
+private:
+    ThreadPool pool;
+    MigrationTopology topology;
+    std::vector<std::unique_ptr<GeneticAlgorithm>> islands;
+
+    void migrate() {
+        if (islands.size() < 2) return;
+
+        // Мигранты выбираются до приёма, чтобы обмен не зависел от порядка островов
+        std::vector<std::vector<Schedule>> outgoing;
+        for (auto& island : islands) outgoing.push_back(island->emigrants(Config::MIGRANTS));
+
+        for (size_t i = 0; i < islands.size(); ++i) {
+            std::vector<Schedule> incoming;
+            if (topology == MigrationTopology::Ring) {
+                size_t from = (i + islands.size() - 1) % islands.size();
+                incoming = outgoing[from];
+            }
+            else {
+                for (size_t from = 0; from < islands.size(); ++from) {
+                    if (from == i) continue;
+                    incoming.insert(incoming.end(), outgoing[from].begin(), outgoing[from].end());
+                }
+            }
+            islands[i]->immigrate(incoming);
+        }
+    }
+
+    // Объединение архивов всех островов в один ограниченный архив
+    std::vector<Schedule> mergedFront() const {
+        ParetoArchive merged;
+        for (auto& island : islands) {
+            const ParetoArchive& archive = island->archive();
+            for (size_t i = 0; i < archive.size(); ++i) merged.offer(archive.schedule(i), archive.objectives(i));
+        }
+        return merged.schedules();
+    }
+};
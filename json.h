@@ -0,0 +1,228 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// Минимальный разбор JSON для файлов задачи: null, bool, числа, строки (UTF-8),
+// массивы и объекты. Порядок ключей объекта сохраняется.
+class Json {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Json() = default;
+
+    static Json parse(const std::string& text) {
+        size_t pos = 0;
+        Json value = parseValue(text, pos);
+        skipSpace(text, pos);
+        if (pos != text.size()) fail("лишние символы после значения", pos);
+        return value;
+    }
+
+    Type type() const { return kind; }
+    bool isNull() const { return kind == Type::Null; }
+    bool isArray() const { return kind == Type::Array; }
+    bool isObject() const { return kind == Type::Object; }
+
+    bool asBool() const {
+        expect(Type::Bool, "логическое значение");
+        return boolean;
+    }
+
+    double asNumber() const {
+        expect(Type::Number, "число");
+        return number;
+    }
+
+    // Целое в диапазоне int; дробное, бесконечное или слишком большое число — ошибка
+    int asInt() const {
+        return static_cast<int>(asInteger(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    }
+
+    // Целое в [low, high]; за пределами ±2^53 double представляет не все целые, поэтому границы уже
+    long long asInteger(long long low, long long high) const {
+        const long long exact = 1ll << 53;
+        double value = asNumber();
+        if (!std::isfinite(value) || value != std::floor(value))
+            throw std::runtime_error("JSON: ожидалось целое число");
+        if (value < static_cast<double>(std::max(low, -exact)) || value > static_cast<double>(std::min(high, exact)))
+            throw std::runtime_error("JSON: целое число вне допустимого диапазона");
+        return static_cast<long long>(value);
+    }
+
+    const std::string& asString() const {
+        expect(Type::String, "строка");
+        return text;
+    }
+
+    // Размер массива или объекта
+    size_t size() const { return kind == Type::Object ? members.size() : items.size(); }
+
+    const Json& operator[](size_t i) const {
+        expect(Type::Array, "массив");
+        if (i >= items.size()) throw std::runtime_error("JSON: индекс за пределами массива");
+        return items[i];
+    }
+
+    const std::vector<Json>& array() const {
+        expect(Type::Array, "массив");
+        return items;
+    }
+
+    const std::vector<std::pair<std::string, Json>>& object() const {
+        expect(Type::Object, "объект");
+        return members;
+    }
+
+    bool contains(const std::string& key) const { return find(key) != nullptr; }
+
+    const Json& operator[](const std::string& key) const {
+        const Json* value = find(key);
+        if (!value) throw std::runtime_error("JSON: нет ключа \"" + key + "\"");
+        return *value;
+    }
+
+    const Json* find(const std::string& key) const {
+        expect(Type::Object, "объект");
+        for (const auto& m : members)
+            if (m.first == key) return &m.second;
+        return nullptr;
+    }
+
+private:
+    Type kind = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> members;
+
+    void expect(Type t, const char* what) const {
+        if (kind != t) throw std::runtime_error(std::string("JSON: ожидалось значение типа ") + what);
+    }
+
+    [[noreturn]] static void fail(const std::string& message, size_t pos) {
+        throw std::runtime_error("JSON: " + message + " (позиция " + std::to_string(pos) + ")");
+    }
+
+    static void skipSpace(const std::string& s, size_t& pos) {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) ++pos;
+    }
+
+    static bool consume(const std::string& s, size_t& pos, const char* word) {
+        size_t n = std::char_traits<char>::length(word);
+        if (s.compare(pos, n, word) != 0) return false;
+        pos += n;
+        return true;
+    }
+
+    // Предел вложенности массивов и объектов: разбор рекурсивный, и без предела
+    // строка из миллиона '[' переполняет стек
+    static constexpr int MAX_DEPTH = 256;
+
+    static Json parseValue(const std::string& s, size_t& pos, int depth = 0) {
+        skipSpace(s, pos);
+        if (pos >= s.size()) fail("неожиданный конец текста", pos);
+        if (depth > MAX_DEPTH) fail("слишком глубокая вложенность", pos);
+
+        Json value;
+        char c = s[pos];
+        if (c == '{') {
+            value.kind = Type::Object;
+            ++pos;
+            skipSpace(s, pos);
+            if (pos < s.size() && s[pos] == '}') { ++pos; return value; }
+            for (;;) {
+                skipSpace(s, pos);
+                if (pos >= s.size() || s[pos] != '"') fail("ожидался ключ", pos);
+                std::string key = parseString(s, pos);
+                skipSpace(s, pos);
+                if (pos >= s.size() || s[pos] != ':') fail("ожидалось ':'", pos);
+                ++pos;
+                value.members.emplace_back(std::move(key), parseValue(s, pos, depth + 1));
+                skipSpace(s, pos);
+                if (pos < s.size() && s[pos] == ',') { ++pos; continue; }
+                if (pos < s.size() && s[pos] == '}') { ++pos; return value; }
+                fail("ожидалось ',' или '}'", pos);
+            }
+        }
+        if (c == '[') {
+            value.kind = Type::Array;
+            ++pos;
+            skipSpace(s, pos);
+            if (pos < s.size() && s[pos] == ']') { ++pos; return value; }
+            for (;;) {
+                value.items.push_back(parseValue(s, pos, depth + 1));
+                skipSpace(s, pos);
+                if (pos < s.size() && s[pos] == ',') { ++pos; continue; }
+                if (pos < s.size() && s[pos] == ']') { ++pos; return value; }
+                fail("ожидалось ',' или ']'", pos);
+            }
+        }
+        if (c == '"') {
+            value.kind = Type::String;
+            value.text = parseString(s, pos);
+            return value;
+        }
+        if (consume(s, pos, "true")) { value.kind = Type::Bool; value.boolean = true; return value; }
+        if (consume(s, pos, "false")) { value.kind = Type::Bool; return value; }
+        if (consume(s, pos, "null")) return value;
+
+        const char* begin = s.c_str() + pos;
+        char* end = nullptr;
+        value.number = std::strtod(begin, &end);
+        if (end == begin) fail("неожиданный символ", pos);
+        value.kind = Type::Number;
+        pos += end - begin;
+        return value;
+    }
+
+    static std::string parseString(const std::string& s, size_t& pos) {
+        std::string out;
+        ++pos; // открывающая кавычка
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c != '\\') { out += c; continue; }
+            if (pos >= s.size()) break;
+            char e = s[pos++];
+            switch (e) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                if (pos + 4 > s.size()) fail("неполная escape-последовательность", pos);
+                unsigned code = static_cast<unsigned>(std::strtoul(s.substr(pos, 4).c_str(), nullptr, 16));
+                pos += 4;
+                appendUtf8(out, code);
+                break;
+            }
+            default: out += e; break; // \" \\ \/
+            }
+        }
+        if (pos >= s.size()) fail("незакрытая строка", pos);
+        ++pos; // закрывающая кавычка
+        return out;
+    }
+
+    static void appendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+};
@@ -1,17 +1,42 @@
 #pragma once
 #include "config.h"
 #include <random>
+#include <cstdint>
+#include <type_traits>
 
+// Тип занятия
+enum class LessonType : uint8_t { Lecture, Practice, Lab };
+
+inline const char* lessonTypeName(LessonType t) {
+    switch (t) {
+    case LessonType::Lecture: return "Лекция";
+    case LessonType::Practice: return "Практика";
+    default: return "Лабораторная";
+    }
+}
+
+// Класс аудитории, подходящий для типа занятия
+inline RoomType requiredRoomType(LessonType t) {
+    switch (t) {
+    case LessonType::Lecture: return RoomType::Lecture;
+    case LessonType::Practice: return RoomType::Computer;
+    default: return RoomType::Lab;
+    }
+}
+
+// Компактный ген: несколько байт на занятие, копируется как POD.
+// Вместимость и класс аудитории берутся по номеру room из Config.
 struct Lesson {
-    int group;      // Номер группы
-    int teacher;    // Номер преподавателя
-    int subject;    // Номер предмета
-    int room;       // Номер аудитории
-    int day;        // День недели
-    int slot;       // Номер слота в дне
-    std::string type; // Тип занятия (Лекция / Практика / Лабораторная)
-    int room_capacity; // Количество мест в аудитории
-    std::string room_type; // Класс аудитории (Компьютерная / Лекционная / Лабораторная)
+    uint16_t group;   // Номер группы
+    uint16_t teacher; // Номер преподавателя
+    uint16_t subject; // Номер предмета
+    uint16_t room;    // Номер аудитории
+    uint8_t day;      // День недели
+    uint8_t slot;     // Номер слота в дне
+    LessonType type;  // Тип занятия (Лекция / Практика / Лабораторная)
 
     Lesson() = default;
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable<Lesson>::value, "Lesson копируется через memcpy");
+static_assert(sizeof(Lesson) <= 12, "Lesson должен оставаться компактным");
\ No newline at end of file
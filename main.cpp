@@ -1,30 +1,33 @@
 #include "genetic_algorithm.h"
 #include <iostream>
+#ifdef _WIN32
 #define NOMINMAX
-#include <windows.h> 
+#include <windows.h>
+#endif
 #include <algorithm>
 
 void printSchedule(const Schedule& s, int index) {
-    auto fitness = s.calculateFitness();
+    const Instance& inst = s.instance();
+    const auto& fitness = s.fitness();
     std::cout << "\n=== Расписание " << index + 1 << " (Конфликты = " << fitness[0]
         << ", Окна = " << fitness[1] << ", Баланс = " << fitness[2]
         << ", Нехватка мест = " << fitness[3] << ", Неподходящий тип = " << fitness[4]
         << ", Нагрузка = " << fitness[5] << ", Дни = " << fitness[6] << ") ===\n";
 
     // Вывод нагрузки преподавателей
-    std::vector<int> load(Config::NUM_TEACHERS, 0);
+    std::vector<int> load(inst.num_teachers, 0);
     for (const auto& l : s.lessons) load[l.teacher]++;
-    static const std::vector<int> target = Config::get_target_pairs();
+    const std::vector<int>& target = inst.target_pairs;
     std::cout << "Нагрузка: ";
-    for (int t = 0; t < Config::NUM_TEACHERS; ++t) {
-        std::cout << Config::teachers[t] << "=" << load[t] << "/" << target[t] << " ";
+    for (int t = 0; t < inst.num_teachers; ++t) {
+        std::cout << inst.teachers[t] << "=" << load[t] << "/" << target[t] << " ";
     }
     std::cout << "\n";
 
-    for (int g = 0; g < Config::NUM_GROUPS; ++g) {
-        std::cout << "\nГруппа: " << Config::groups[g] << " (" << Config::group_sizes[g] << " студентов)\n";
-        for (int d = 0; d < Config::NUM_DAYS; ++d) {
-            std::cout << "  " << Config::days[d] << ":\n";
+    for (int g = 0; g < inst.num_groups; ++g) {
+        std::cout << "\nГруппа: " << inst.groups[g] << " (" << inst.group_sizes[g] << " студентов)\n";
+        for (int d = 0; d < inst.num_days; ++d) {
+            std::cout << "  " << inst.days[d] << ":\n";
             std::vector<Lesson> day_lessons;
             for (auto& l : s.lessons)
                 if (l.group == g && l.day == d)
@@ -34,23 +37,36 @@ void printSchedule(const Schedule& s, int index) {
 
             for (auto& l : day_lessons) {
                 std::cout << "    Лента " << l.slot + 1 << ": "
-                    << Config::subjects[l.subject] << " ведет "
-                    << Config::teachers[l.teacher] << " в аудитории "
-                    << Config::rooms[l.room] << " (" << l.room_type << ", " << l.room_capacity << " мест, " << l.type << ")\n";
+                    << inst.subjects[l.subject] << " ведет "
+                    << inst.teachers[l.teacher] << " в аудитории "
+                    << inst.rooms[l.room] << " (" << roomTypeName(inst.room_types[l.room]) << ", "
+                    << inst.room_capacities[l.room] << " мест, " << lessonTypeName(l.type) << ")\n";
             }
         }
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+#ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
+#endif
     setlocale(LC_ALL, "ru_RU.UTF-8");
-    GeneticAlgorithm ga;
+    // Файл задачи можно передать первым аргументом, иначе используются тестовые данные
+    Instance instance;
+    try {
+        instance = argc > 1 ? Instance::load(argv[1]) : Instance::fromConfig();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    GeneticAlgorithm ga(instance, std::random_device{}());
     std::vector<Schedule> pareto_front = ga.run();
 
     std::sort(pareto_front.begin(), pareto_front.end(), [](const Schedule& a, const Schedule& b) {
-        auto fa = a.calculateFitness();
-        auto fb = b.calculateFitness();
+        const auto& fa = a.fitness();
+        const auto& fb = b.fitness();
         if (fa[0] != fb[0]) return fa[0] < fb[0];
         if (fa[5] != fb[5]) return fa[5] < fb[5]; // Нагрузка — второй приоритет
         if (fa[1] != fb[1]) return fa[1] < fb[1];
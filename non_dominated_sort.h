@@ -0,0 +1,118 @@
+#pragma once
+#include "schedule.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <chrono>
+
+// Сортировка по недоминированию (Efficient Non-dominated Sort, ENS-SS)
+// и crowding distance по плоской матрице целей.
+// Решения упорядочиваются лексикографически, поэтому доминировать над решением
+// могут только предшествующие ему; каждое решение кладётся в первый фронт,
+// где его никто не доминирует. Фронты хранятся односвязными списками
+// в массивах размера n, буферы переиспользуются между вызовами,
+// так что при неизменном размере популяции сортировка не выделяет память.
+class NonDominatedSorter {
+public:
+    using Fitness = Schedule::Fitness;
+
+    // Проверка доминирования (минимизация всех целей)
+    static bool dominates(const Fitness& a, const Fitness& b) {
+        bool at_least_one_better = false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i] > b[i]) return false; // a не доминирует b, если хуже хотя бы в одной цели
+            if (a[i] < b[i]) at_least_one_better = true;
+        }
+        return at_least_one_better;
+    }
+
+    // Заполняет rank (номер фронта) и crowding distance для каждого решения
+    void sort(const std::vector<Fitness>& objectives, std::vector<int>& rank, std::vector<double>& crowding) {
+        const size_t n = objectives.size();
+        rank.resize(n);
+        crowding.assign(n, 0.0);
+        num_fronts = 0;
+        sort_seconds = crowding_seconds = 0.0;
+        if (n == 0) return;
+        auto start = std::chrono::steady_clock::now();
+
+        // Шаг 1: лексикографический порядок
+        order.resize(n);
+        for (size_t i = 0; i < n; ++i) order[i] = static_cast<int>(i);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return objectives[a] < objectives[b];
+        });
+
+        // Шаг 2: последовательный поиск первого подходящего фронта
+        front_head.resize(n);
+        next_in_front.resize(n);
+        for (int p : order) {
+            size_t f = 0;
+            for (; f < num_fronts; ++f) {
+                if (!dominatedByFront(objectives, front_head[f], p)) break;
+            }
+            if (f == num_fronts) front_head[num_fronts++] = -1;
+            next_in_front[p] = front_head[f];
+            front_head[f] = p;
+            rank[p] = static_cast<int>(f);
+        }
+
+        auto sorted = std::chrono::steady_clock::now();
+        sort_seconds = std::chrono::duration<double>(sorted - start).count();
+
+        // Шаг 3: crowding distance по всем целям
+        by_objective.reserve(n);
+        for (size_t f = 0; f < num_fronts; ++f) {
+            computeCrowding(objectives, front_head[f], crowding);
+        }
+        crowding_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sorted).count();
+    }
+
+    size_t frontCount() const { return num_fronts; }
+
+    // Длительность шагов последнего вызова sort: разбиение на фронты и crowding distance
+    double lastSortSeconds() const { return sort_seconds; }
+    double lastCrowdingSeconds() const { return crowding_seconds; }
+
+private:
+    std::vector<int> order;
+    std::vector<int> front_head;    // Последнее добавленное решение каждого фронта
+    std::vector<int> next_in_front; // Предыдущее решение того же фронта, -1 — конец списка
+    size_t num_fronts = 0;
+    std::vector<int> by_objective;
+    double sort_seconds = 0.0;
+    double crowding_seconds = 0.0;
+
+    // Решения фронта добавлены раньше p; список начинается с ближайших к p, их проверяем первыми
+    bool dominatedByFront(const std::vector<Fitness>& objectives, int head, int p) const {
+        for (int q = head; q >= 0; q = next_in_front[q]) {
+            if (dominates(objectives[q], objectives[p])) return true;
+        }
+        return false;
+    }
+
+    void computeCrowding(const std::vector<Fitness>& objectives, int head, std::vector<double>& crowding) {
+        const double inf = std::numeric_limits<double>::infinity();
+        by_objective.clear();
+        for (int q = head; q >= 0; q = next_in_front[q]) by_objective.push_back(q);
+        if (by_objective.size() <= 2) {
+            for (int i : by_objective) crowding[i] = inf;
+            return;
+        }
+
+        for (size_t obj = 0; obj < Schedule::NUM_OBJECTIVES; ++obj) {
+            std::sort(by_objective.begin(), by_objective.end(), [&](int i, int j) {
+                return objectives[i][obj] < objectives[j][obj];
+            });
+
+            crowding[by_objective.front()] = crowding[by_objective.back()] = inf;
+            double range = objectives[by_objective.back()][obj] - objectives[by_objective.front()][obj];
+            if (range == 0) continue;
+
+            for (size_t i = 1; i + 1 < by_objective.size(); ++i) {
+                crowding[by_objective[i]] += (objectives[by_objective[i + 1]][obj] -
+                    objectives[by_objective[i - 1]][obj]) / range;
+            }
+        }
+    }
+};
@@ -0,0 +1,141 @@
+#pragma once
+#include "lesson.h"
+#include "instance.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Битовые операции над маской слотов дня
+namespace Bits {
+    inline int popcount(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#else
+        int n = 0;
+        for (; x; x &= x - 1) ++n;
+        return n;
+#endif
+    }
+
+    // Номер младшего установленного бита (x != 0)
+    inline int lowest(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(x);
+#else
+        int n = 0;
+        while (!(x & 1)) { x >>= 1; ++n; }
+        return n;
+#endif
+    }
+
+    // Номер старшего установленного бита (x != 0)
+    inline int highest(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(x);
+#else
+        int n = 0;
+        while (x >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    // Число пустых слотов между первой и последней парой дня
+    inline int gaps(uint64_t mask) {
+        if (!mask) return 0;
+        return highest(mask) - lowest(mask) + 1 - popcount(mask);
+    }
+}
+
+// Индекс занятости: счётчики занятий в каждой ячейке (день, слот)
+// для групп, преподавателей и аудиторий, плюс маски слотов по группе-дню.
+// Строится за один проход по занятиям, конфликты считаются по ходу.
+class OccupancyGrid {
+public:
+    // Размеры берутся из экземпляра; память переиспользуется, если они не изменились.
+    // Маска слотов дня хранится в uint64_t: Instance::finalize ограничивает день 64 парами.
+    void build(const Instance& instance, const std::vector<Lesson>& lessons) {
+        reset(instance);
+        for (const auto& l : lessons) add(l);
+    }
+
+    // Поставить занятие в индекс
+    void add(const Lesson& l) {
+        // Новое занятие образует пару с каждым, уже стоящим в этой ячейке
+        conflicts += group_cells[cell(l.group, l.day, l.slot)]++;
+        conflicts += teacher_cells[cell(l.teacher, l.day, l.slot)]++;
+        conflicts += room_cells[cell(l.room, l.day, l.slot)]++;
+        group_day_mask[l.group * num_days + l.day] |= uint64_t(1) << l.slot;
+        group_day_count[l.group * num_days + l.day]++;
+    }
+
+    // Убрать занятие из индекса (обратная операция к add)
+    void remove(const Lesson& l) {
+        conflicts -= --group_cells[cell(l.group, l.day, l.slot)];
+        conflicts -= --teacher_cells[cell(l.teacher, l.day, l.slot)];
+        conflicts -= --room_cells[cell(l.room, l.day, l.slot)];
+        if (group_cells[cell(l.group, l.day, l.slot)] == 0)
+            group_day_mask[l.group * num_days + l.day] &= ~(uint64_t(1) << l.slot);
+        group_day_count[l.group * num_days + l.day]--;
+    }
+
+    // Число пар занятий в одной ячейке (по группам, преподавателям и аудиториям)
+    long long hardConflicts() const { return conflicts; }
+
+    // Сумма окон по всем группам и дням
+    long long gaps() const {
+        long long total = 0;
+        for (uint64_t mask : group_day_mask) total += Bits::gaps(mask);
+        return total;
+    }
+
+    // Сумма квадратов отклонений числа пар в день от среднего по группе
+    double balance() const {
+        double total = 0.0;
+        for (int g = 0; g < num_groups; ++g) {
+            const uint16_t* per_day = &group_day_count[g * num_days];
+            double mean = 0.0;
+            for (int d = 0; d < num_days; ++d) mean += per_day[d];
+            mean /= num_days;
+            for (int d = 0; d < num_days; ++d) {
+                double diff = per_day[d] - mean;
+                total += diff * diff;
+            }
+        }
+        return total;
+    }
+
+    int groupCount(int group, int day, int slot) const { return group_cells[cell(group, day, slot)]; }
+    int teacherCount(int teacher, int day, int slot) const { return teacher_cells[cell(teacher, day, slot)]; }
+    int roomCount(int room, int day, int slot) const { return room_cells[cell(room, day, slot)]; }
+    uint64_t groupDayMask(int group, int day) const { return group_day_mask[group * num_days + day]; }
+    int groupDayCount(int group, int day) const { return group_day_count[group * num_days + day]; }
+
+private:
+    int num_groups = 0;
+    int num_days = 0;
+    int slots_per_day = 0;
+
+    std::vector<uint16_t> group_cells;
+    std::vector<uint16_t> teacher_cells;
+    std::vector<uint16_t> room_cells;
+    std::vector<uint64_t> group_day_mask;
+    std::vector<uint16_t> group_day_count;
+    long long conflicts = 0;
+
+    int cell(int owner, int day, int slot) const {
+        return (owner * num_days + day) * slots_per_day + slot;
+    }
+
+    void reset(const Instance& instance) {
+        num_groups = instance.num_groups;
+        num_days = instance.num_days;
+        slots_per_day = instance.slots_per_day;
+        const int cells = num_days * slots_per_day;
+        group_cells.assign(instance.num_groups * cells, 0);
+        teacher_cells.assign(instance.num_teachers * cells, 0);
+        room_cells.assign(instance.num_rooms * cells, 0);
+        group_day_mask.assign(instance.num_groups * num_days, 0);
+        group_day_count.assign(instance.num_groups * num_days, 0);
+        conflicts = 0;
+    }
+};
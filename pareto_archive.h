@@ -0,0 +1,129 @@
+#pragma once
+#include "schedule.h"
+#include "non_dominated_sort.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+// Внешний архив недоминируемых расписаний ограниченного размера.
+// Члены хранятся в лексикографическом порядке целей: доминировать над
+// кандидатом может только член левее точки вставки, а доминируемые
+// кандидатом члены лежат правее, поэтому каждая проверка просматривает
+// лишь свою часть списка. При переполнении удаляется член с наименьшим
+// crowding distance. Слоты расписаний переиспользуются, так что после
+// прогрева вставка копирует гены в уже выделенную память.
+class ParetoArchive {
+public:
+    using Fitness = Schedule::Fitness;
+
+    // Служебные списки рассчитаны на capacity + 1 слот сразу: при росте архива
+    // память выделяется только под гены новых слотов
+    explicit ParetoArchive(size_t capacity = Config::ARCHIVE_SIZE) : max_size(std::max<size_t>(capacity, 2)) {
+        entries.reserve(max_size + 1);
+        order.reserve(max_size + 1);
+        free_slots.reserve(max_size + 1);
+        crowding.reserve(max_size + 1);
+        by_objective.reserve(max_size + 1);
+    }
+
+    void clear() {
+        for (int slot : order) free_slots.push_back(slot);
+        order.clear();
+    }
+
+    // Предложить расписание с целями f; true — оно вошло в архив
+    bool offer(const Schedule& s, const Fitness& f) {
+        size_t pos = std::lower_bound(order.begin(), order.end(), f, [&](int slot, const Fitness& x) {
+            return entries[slot].objectives < x;
+        }) - order.begin();
+        if (pos < order.size() && entries[order[pos]].objectives == f) return false;
+        for (size_t i = 0; i < pos; ++i) {
+            if (NonDominatedSorter::dominates(entries[order[i]].objectives, f)) return false;
+        }
+
+        // Кандидат принят: вытесняем доминируемых им членов
+        auto dominated = [&](int slot) {
+            if (!NonDominatedSorter::dominates(f, entries[slot].objectives)) return false;
+            free_slots.push_back(slot);
+            return true;
+        };
+        order.erase(std::remove_if(order.begin() + pos, order.end(), dominated), order.end());
+
+        int slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            entries[slot].schedule = s;
+            entries[slot].objectives = f;
+        }
+        else {
+            slot = static_cast<int>(entries.size());
+            entries.push_back({ s, f });
+        }
+        order.insert(order.begin() + pos, slot);
+
+        // При переполнении вытесненным может оказаться и сам кандидат
+        if (order.size() > max_size) return prune() != slot;
+        return true;
+    }
+
+    bool offer(const Schedule& s) { return offer(s, s.fitness()); }
+
+    size_t size() const { return order.size(); }
+    size_t capacity() const { return max_size; }
+    bool empty() const { return order.empty(); }
+    // Выделенных слотов расписаний (занятых и свободных); растёт только до capacity() + 1
+    size_t slots() const { return entries.size(); }
+
+    // Члены архива в лексикографическом порядке целей
+    const Schedule& schedule(size_t i) const { return entries[order[i]].schedule; }
+    const Fitness& objectives(size_t i) const { return entries[order[i]].objectives; }
+
+    std::vector<Schedule> schedules() const {
+        std::vector<Schedule> result;
+        result.reserve(order.size());
+        for (int slot : order) result.push_back(entries[slot].schedule);
+        return result;
+    }
+
+private:
+    struct Entry {
+        Schedule schedule;
+        Fitness objectives;
+    };
+
+    size_t max_size;
+    std::vector<Entry> entries;     // Слоты; занятые перечислены в order
+    std::vector<int> order;         // Занятые слоты по возрастанию целей
+    std::vector<int> free_slots;
+    std::vector<double> crowding;   // По позиции в order
+    std::vector<int> by_objective;
+
+    // Удалить член с наименьшим crowding distance и вернуть его слот; крайние по каждой цели сохраняются
+    int prune() {
+        const double inf = std::numeric_limits<double>::infinity();
+        const size_t n = order.size();
+        crowding.assign(n, 0.0);
+        by_objective.resize(n);
+        for (size_t obj = 0; obj < Schedule::NUM_OBJECTIVES; ++obj) {
+            for (size_t i = 0; i < n; ++i) by_objective[i] = static_cast<int>(i);
+            std::sort(by_objective.begin(), by_objective.end(), [&](int a, int b) {
+                return entries[order[a]].objectives[obj] < entries[order[b]].objectives[obj];
+            });
+            crowding[by_objective.front()] = crowding[by_objective.back()] = inf;
+            double range = entries[order[by_objective.back()]].objectives[obj] -
+                entries[order[by_objective.front()]].objectives[obj];
+            if (range == 0) continue;
+            for (size_t i = 1; i + 1 < n; ++i) {
+                crowding[by_objective[i]] += (entries[order[by_objective[i + 1]]].objectives[obj] -
+                    entries[order[by_objective[i - 1]]].objectives[obj]) / range;
+            }
+        }
+
+        size_t worst = std::min_element(crowding.begin(), crowding.end()) - crowding.begin();
+        int slot = order[worst];
+        free_slots.push_back(slot);
+        order.erase(order.begin() + worst);
+        return slot;
+    }
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include "incremental_evaluator.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+
+// Ремонт расписания и локальный поиск (меметический оператор).
+// Занятия, попавшие в накладку группы, преподавателя или аудитории либо
+// стоящие в аудитории не того класса или вместимости, переносятся в лучшую
+// ячейку (день, пара), где свободны группа и преподаватель, в наименьшую
+// подходящую свободную аудиторию. Затем подъём по мягким целям: случайные
+// переносы в свободные ячейки, принимаются только улучшающие.
+// Ходы сравниваются лексикографически: сначала число нарушений
+// (накладки, вместимость, класс), затем свёртка целей Schedule::weightedFitness.
+// Объект держит буферы между вызовами и используется одним потоком.
+class Repairer {
+public:
+    // Отремонтировать расписание и сделать steps попыток локального поиска.
+    // После вызова кэш целей расписания актуален.
+    void repair(Schedule& s, std::mt19937& gen, int steps = Config::LOCAL_SEARCH_STEPS) {
+        schedule = &s;
+        evaluator.attach(s);
+        Schedule::Fitness ones;
+        ones.fill(1.0);
+        scale = s.normalizeFitness(ones, s.lessons.size());
+
+        conflicted.clear();
+        conflicted.reserve(s.lessons.size());
+        for (size_t i = 0; i < s.lessons.size(); ++i)
+            if (violates(s.lessons[i])) conflicted.push_back(i);
+        std::shuffle(conflicted.begin(), conflicted.end(), gen);
+        // Ходы до commit: не больше одного на занятие с накладкой и одного на шаг поиска.
+        // Граница берётся по всем занятиям, чтобы ёмкость не росла от вызова к вызову
+        evaluator.reserve(s.lessons.size() + static_cast<size_t>(std::max(steps, 0)));
+
+        for (size_t i : conflicted) {
+            if (violates(s.lessons[i])) relocate(i); // Накладка могла уйти вместе с соседом
+        }
+
+        hillClimb(steps, gen);
+        evaluator.commit();
+    }
+
+    // Число оценённых ходов за всё время жизни объекта
+    long long moveEvaluations() const { return move_evaluations; }
+
+private:
+    // Нарушения жёстких ограничений и свёрнутые цели; меньше — лучше
+    struct Score {
+        long long violations;
+        double soft;
+        bool operator<(const Score& o) const {
+            return violations != o.violations ? violations < o.violations : soft < o.soft;
+        }
+    };
+
+    Schedule* schedule = nullptr;
+    IncrementalEvaluator evaluator;
+    Schedule::Fitness scale{};   // Множители нормировки: цели линейны по ненормированным суммам
+    std::vector<size_t> conflicted;
+    long long move_evaluations = 0;
+
+    bool violates(const Lesson& l) const {
+        const OccupancyGrid& grid = evaluator.occupancy();
+        return grid.groupCount(l.group, l.day, l.slot) > 1 || grid.teacherCount(l.teacher, l.day, l.slot) > 1 ||
+            grid.roomCount(l.room, l.day, l.slot) > 1 || schedule->capacityConflict(l) || schedule->typeConflict(l);
+    }
+
+    Score score() const {
+        Schedule::Fitness raw = evaluator.rawFitness();
+        Schedule::Fitness normalized;
+        for (size_t k = 0; k < raw.size(); ++k) normalized[k] = raw[k] * scale[k];
+        return { static_cast<long long>(raw[0] + raw[3] + raw[4]), Schedule::weightedFitness(normalized) };
+    }
+
+    Score scoreMove(size_t index, const Lesson& to) {
+        ++move_evaluations;
+        evaluator.apply(index, to);
+        Score result = score();
+        evaluator.undo();
+        return result;
+    }
+
+    // Свободны ли группа и преподаватель занятия в ячейке (не считая самого занятия)
+    bool cellFree(const Lesson& l, int day, int slot) const {
+        const OccupancyGrid& grid = evaluator.occupancy();
+        int own = (l.day == day && l.slot == slot) ? 1 : 0;
+        return grid.groupCount(l.group, day, slot) == own && grid.teacherCount(l.teacher, day, slot) == own;
+    }
+
+    // Свободная аудитория для занятия from в ячейке (day, slot): наименьшая подходящего
+    // класса и вместимости, иначе наибольшая подходящего класса, иначе любая; -1 — нет
+    int freeRoom(const Lesson& from, int day, int slot) const {
+        const Instance& inst = schedule->instance();
+        const OccupancyGrid& grid = evaluator.occupancy();
+        auto is_free = [&](int r) {
+            int own = (from.day == day && from.slot == slot && from.room == r) ? 1 : 0;
+            return grid.roomCount(r, day, slot) == own;
+        };
+
+        const auto& typed = inst.rooms_by_type[static_cast<int>(requiredRoomType(from.type))];
+        const int size = inst.group_sizes[from.group];
+        auto fits = std::partition_point(typed.begin(), typed.end(), [&](int r) {
+            return inst.room_capacities[r] < size;
+        });
+        for (auto it = fits; it != typed.end(); ++it)
+            if (is_free(*it)) return *it;
+        for (auto it = fits; it != typed.begin();)
+            if (is_free(*--it)) return *it;
+        for (int r = 0; r < inst.num_rooms; ++r)
+            if (is_free(r)) return r;
+        return -1;
+    }
+
+    // Перенести занятие в лучшую свободную ячейку, если это улучшает расписание
+    void relocate(size_t index) {
+        const Instance& inst = schedule->instance();
+        const Lesson from = schedule->lessons[index];
+        Score best = score();
+        Lesson best_move = from;
+        bool found = false;
+
+        for (int d = 0; d < inst.num_days; ++d) {
+            for (int slot = 0; slot < inst.slots_per_day; ++slot) {
+                if (!cellFree(from, d, slot)) continue;
+                int room = freeRoom(from, d, slot);
+                if (room < 0) continue;
+
+                Lesson to = from;
+                to.day = static_cast<uint8_t>(d);
+                to.slot = static_cast<uint8_t>(slot);
+                to.room = static_cast<uint16_t>(room);
+                Score candidate = scoreMove(index, to);
+                if (candidate < best) {
+                    best = candidate;
+                    best_move = to;
+                    found = true;
+                }
+            }
+        }
+        if (found) evaluator.apply(index, best_move);
+    }
+
+    // Случайные переносы в свободные ячейки; принимаются только улучшающие
+    void hillClimb(int steps, std::mt19937& gen) {
+        const Instance& inst = schedule->instance();
+        if (schedule->lessons.empty()) return;
+        std::uniform_int_distribution<size_t> lesson_dist(0, schedule->lessons.size() - 1);
+        std::uniform_int_distribution<> day_dist(0, inst.num_days - 1);
+        std::uniform_int_distribution<> slot_dist(0, inst.slots_per_day - 1);
+        std::uniform_real_distribution<> prob(0, 1);
+
+        Score current = score();
+        for (int step = 0; step < steps; ++step) {
+            size_t index = lesson_dist(gen);
+            const Lesson from = schedule->lessons[index];
+            // Чаще двигаем в пределах дня: это убирает окна, не ломая баланс
+            int d = prob(gen) < 0.7 ? from.day : day_dist(gen);
+            int slot = slot_dist(gen);
+            if (!cellFree(from, d, slot)) continue;
+            int room = freeRoom(from, d, slot);
+            if (room < 0) continue;
+
+            Lesson to = from;
+            to.day = static_cast<uint8_t>(d);
+            to.slot = static_cast<uint8_t>(slot);
+            to.room = static_cast<uint16_t>(room);
+            evaluator.apply(index, to);
+            ++move_evaluations;
+            Score candidate = score();
+            if (candidate < current) current = candidate;
+            else evaluator.undo();
+        }
+    }
+};
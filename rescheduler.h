@@ -0,0 +1,352 @@
+#pragma once
+#include "incremental_evaluator.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <stdexcept>
+
+// Изменения к готовому расписанию: недоступные преподаватели, закрытые
+// аудитории и новые занятия. Маска дней: бит d — день d; 0 — вся неделя.
+struct Disruption {
+    struct Closure {
+        int index;
+        uint64_t days;
+    };
+    std::vector<Closure> unavailable_teachers;
+    std::vector<Closure> closed_rooms;
+    std::vector<Lesson> added_lessons;  // Положение (день, пара, аудитория) подбирается заново
+
+    void teacherUnavailable(int teacher, uint64_t days = 0) { unavailable_teachers.push_back({ teacher, days }); }
+    void closeRoom(int room, uint64_t days = 0) { closed_rooms.push_back({ room, days }); }
+
+    void addLesson(int group, int teacher, int subject, LessonType type) {
+        Lesson l{};
+        l.group = static_cast<uint16_t>(group);
+        l.teacher = static_cast<uint16_t>(teacher);
+        l.subject = static_cast<uint16_t>(subject);
+        l.type = type;
+        added_lessons.push_back(l);
+    }
+};
+
+// Результат перепланирования. Новые занятия дописываются в конец schedule.lessons,
+// поэтому при непустом Disruption::added_lessons расписание длиннее
+// Instance::lessonsPerSchedule(): его нельзя передать в GeneticAlgorithm::seed
+// или записать в снимок (checkpoint.h), там число генов сверяется с экземпляром.
+struct RescheduleResult {
+    Schedule schedule;
+    std::vector<size_t> changed;    // Занятия, отличающиеся от исходных, и новые занятия
+    long long violations = 0;       // Оставшиеся накладки, нарушения вместимости, класса и изменений
+    double seconds = 0.0;
+};
+
+// Перепланирование после изменений без полного прогона GA.
+// Двигаются только затронутые занятия: стоящие у недоступного преподавателя
+// или в закрытой аудитории и новые. Каждое переносится в лучшую ячейку
+// (день, пара) с лучшей аудиторией; если у преподавателя день закрыт,
+// пробуются и другие преподаватели того же предмета. Если нарушения
+// остались, в следующем круге двигаться могут и занятия, с которыми
+// затронутые делят ячейку. Затем подъём по мягким целям среди
+// сдвинутых занятий. Ходы оцениваются IncrementalEvaluator и сравниваются
+// лексикографически, как в Repairer: сначала нарушения, затем свёртка целей
+// плюс штраф за отклонение от исходного расписания (перенос во времени — 1,
+// смена аудитории или преподавателя — по 0.5, в долях числа занятий,
+// с весом Config::RESCHEDULE_DEVIATION_WEIGHT).
+// Объект держит буферы между вызовами и используется одним потоком.
+class Rescheduler {
+public:
+    RescheduleResult reschedule(const Schedule& original, const Disruption& disruption, std::mt19937& gen,
+        int steps = Config::LOCAL_SEARCH_STEPS) {
+        const auto start = std::chrono::steady_clock::now();
+        const Instance& inst = original.instance();
+        validate(inst, disruption);
+        RescheduleResult result{ original, {}, 0, 0.0 };
+        Schedule& s = result.schedule;
+        schedule = &s;
+
+        teacher_closed.assign(inst.num_teachers, 0);
+        room_closed.assign(inst.num_rooms, 0);
+        const uint64_t all_days = inst.num_days == 64 ? ~uint64_t(0) : (uint64_t(1) << inst.num_days) - 1;
+        for (const auto& c : disruption.unavailable_teachers) teacher_closed[c.index] |= c.days ? c.days : all_days;
+        for (const auto& c : disruption.closed_rooms) room_closed[c.index] |= c.days ? c.days : all_days;
+
+        teachers_by_subject.assign(inst.num_subjects, {});
+        for (const auto& p : inst.teacher_subject_pairs) teachers_by_subject[p.second].push_back(p.first);
+
+        origin = s.lessons;
+        added = s.lessons.size();
+        for (Lesson l : disruption.added_lessons) {
+            l.day = 0;
+            l.slot = 0;
+            l.room = 0;
+            s.lessons.push_back(l);
+        }
+        evaluator.attach(s);
+        Schedule::Fitness ones;
+        ones.fill(1.0);
+        scale = s.normalizeFitness(ones, s.lessons.size());
+        deviation_unit = Config::RESCHEDULE_DEVIATION_WEIGHT / std::max<size_t>(s.lessons.size(), 1);
+        deviation = 0.0;
+
+        movable.assign(s.lessons.size(), 0);
+        queue.clear();
+        for (size_t i = 0; i < s.lessons.size(); ++i)
+            if (i >= added || blocked(s.lessons[i])) queue.push_back(i);
+
+        for (int round = 0; round < Config::RESCHEDULE_ROUNDS && !queue.empty(); ++round) {
+            std::shuffle(queue.begin(), queue.end(), gen);
+            for (size_t i : queue) {
+                movable[i] = 1;
+                if (i >= added || violates(s.lessons[i])) relocate(i);
+            }
+            collectConflicts();
+        }
+
+        hillClimb(steps, gen);
+        evaluator.commit();
+
+        for (size_t i = 0; i < s.lessons.size(); ++i) {
+            const Lesson& l = s.lessons[i];
+            if (i >= added || l.day != origin[i].day || l.slot != origin[i].slot || l.room != origin[i].room ||
+                l.teacher != origin[i].teacher) result.changed.push_back(i);
+            if (blocked(l)) ++result.violations;
+        }
+        Schedule::Fitness raw = evaluator.rawFitness();
+        result.violations += static_cast<long long>(raw[0] + raw[3] + raw[4]);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // Число оценённых ходов за всё время жизни объекта
+    long long moveEvaluations() const { return move_evaluations; }
+
+private:
+    // Нарушения жёстких ограничений и свёрнутые цели с отклонением; меньше — лучше
+    struct Score {
+        long long violations;
+        double soft;
+        bool operator<(const Score& o) const {
+            return violations != o.violations ? violations < o.violations : soft < o.soft;
+        }
+    };
+
+    Schedule* schedule = nullptr;
+    IncrementalEvaluator evaluator;
+    Schedule::Fitness scale{};
+    std::vector<uint64_t> teacher_closed;   // Маска закрытых дней по преподавателю
+    std::vector<uint64_t> room_closed;      // Маска закрытых дней по аудитории
+    std::vector<std::vector<int>> teachers_by_subject;
+    std::vector<Lesson> origin;             // Исходные положения первых added занятий
+    size_t added = 0;                       // Номер первого нового занятия
+    double deviation_unit = 0.0;            // Вес единицы отклонения
+    double deviation = 0.0;                 // Текущее отклонение от исходного расписания
+    std::vector<char> movable;
+    std::vector<size_t> queue;
+    long long move_evaluations = 0;
+
+    // Номера из disruption идут в таблицы экземпляра без проверки границ, поэтому проверяются заранее.
+    // День, пару и аудиторию новых занятий подбирает reschedule, их значения не используются
+    static void validate(const Instance& inst, const Disruption& disruption) {
+        const uint64_t all_days = inst.num_days == 64 ? ~uint64_t(0) : (uint64_t(1) << inst.num_days) - 1;
+        for (const auto& c : disruption.unavailable_teachers) {
+            check(c.index >= 0 && c.index < inst.num_teachers, "несуществующий преподаватель");
+            check((c.days & ~all_days) == 0, "маска дней преподавателя вне недели");
+        }
+        for (const auto& c : disruption.closed_rooms) {
+            check(c.index >= 0 && c.index < inst.num_rooms, "несуществующая аудитория");
+            check((c.days & ~all_days) == 0, "маска дней аудитории вне недели");
+        }
+        for (const Lesson& l : disruption.added_lessons) {
+            check(l.group < inst.num_groups, "новое занятие у несуществующей группы");
+            check(l.teacher < inst.num_teachers, "новое занятие у несуществующего преподавателя");
+            check(l.subject < inst.num_subjects, "новое занятие по несуществующему предмету");
+            check(l.type <= LessonType::Lab, "новое занятие неизвестного типа");
+        }
+    }
+
+    static void check(bool condition, const char* message) {
+        if (!condition) throw std::runtime_error(std::string("некорректные изменения расписания: ") + message);
+    }
+
+    bool blocked(const Lesson& l) const {
+        return ((teacher_closed[l.teacher] | room_closed[l.room]) >> l.day) & 1;
+    }
+
+    bool violates(const Lesson& l) const {
+        const OccupancyGrid& grid = evaluator.occupancy();
+        return blocked(l) || grid.groupCount(l.group, l.day, l.slot) > 1 || grid.teacherCount(l.teacher, l.day, l.slot) > 1 ||
+            grid.roomCount(l.room, l.day, l.slot) > 1 || schedule->capacityConflict(l) || schedule->typeConflict(l);
+    }
+
+    double lessonDeviation(size_t index, const Lesson& l) const {
+        if (index >= added) return 0.0;
+        const Lesson& o = origin[index];
+        return (l.day != o.day || l.slot != o.slot ? 1.0 : 0.0) + (l.room != o.room ? 0.5 : 0.0) +
+            (l.teacher != o.teacher ? 0.5 : 0.0);
+    }
+
+    Score score() const {
+        Schedule::Fitness raw = evaluator.rawFitness();
+        Schedule::Fitness normalized;
+        for (size_t k = 0; k < raw.size(); ++k) normalized[k] = raw[k] * scale[k];
+        return { static_cast<long long>(raw[0] + raw[3] + raw[4]),
+            Schedule::weightedFitness(normalized) + deviation * deviation_unit };
+    }
+
+    void apply(size_t index, const Lesson& to) {
+        deviation += lessonDeviation(index, to) - lessonDeviation(index, schedule->lessons[index]);
+        evaluator.apply(index, to);
+    }
+
+    void undo(size_t index, const Lesson& from) {
+        deviation += lessonDeviation(index, from) - lessonDeviation(index, schedule->lessons[index]);
+        evaluator.undo();
+    }
+
+    Score scoreMove(size_t index, const Lesson& to) {
+        ++move_evaluations;
+        const Lesson from = schedule->lessons[index];
+        apply(index, to);
+        Score result = score();
+        undo(index, from);
+        return result;
+    }
+
+    // Аудитория для занятия from в ячейке (day, slot): исходная, если свободна и подходит,
+    // затем наименьшая свободная подходящего класса и вместимости, наибольшая свободная
+    // подходящего класса, любая свободная, любая открытая; -1 — все закрыты
+    int chooseRoom(size_t index, const Lesson& from, int day, int slot) const {
+        const Instance& inst = schedule->instance();
+        const OccupancyGrid& grid = evaluator.occupancy();
+        auto open = [&](int r) { return !((room_closed[r] >> day) & 1); };
+        auto is_free = [&](int r) {
+            int own = (from.day == day && from.slot == slot && from.room == r) ? 1 : 0;
+            return open(r) && grid.roomCount(r, day, slot) == own;
+        };
+
+        if (index < added) {
+            Lesson probe = from;
+            probe.room = origin[index].room;
+            if (is_free(probe.room) && !schedule->capacityConflict(probe) && !schedule->typeConflict(probe)) return probe.room;
+        }
+        const auto& typed = inst.rooms_by_type[static_cast<int>(requiredRoomType(from.type))];
+        const int size = inst.group_sizes[from.group];
+        auto fits = std::partition_point(typed.begin(), typed.end(), [&](int r) {
+            return inst.room_capacities[r] < size;
+        });
+        for (auto it = fits; it != typed.end(); ++it)
+            if (is_free(*it)) return *it;
+        for (auto it = fits; it != typed.begin();)
+            if (is_free(*--it)) return *it;
+        for (int r = 0; r < inst.num_rooms; ++r)
+            if (is_free(r)) return r;
+        for (int r = 0; r < inst.num_rooms; ++r)
+            if (open(r)) return r;
+        return -1;
+    }
+
+    // Перенести занятие в лучшую открытую ячейку; занятую ячейку выбирают, только если
+    // свободной нет, и тогда её занятие двигается в следующем круге
+    void relocate(size_t index) {
+        const Instance& inst = schedule->instance();
+        const Lesson from = schedule->lessons[index];
+        Score best = violates(from) ? Score{ std::numeric_limits<long long>::max(), 0.0 } : score();
+        Lesson best_move = from;
+        bool found = false;
+
+        auto tryTeacher = [&](int teacher) {
+            for (int d = 0; d < inst.num_days; ++d) {
+                if ((teacher_closed[teacher] >> d) & 1) continue;
+                for (int slot = 0; slot < inst.slots_per_day; ++slot) {
+                    Lesson to = from;
+                    to.teacher = static_cast<uint16_t>(teacher);
+                    int room = chooseRoom(index, to, d, slot);
+                    if (room < 0) continue;
+                    to.day = static_cast<uint8_t>(d);
+                    to.slot = static_cast<uint8_t>(slot);
+                    to.room = static_cast<uint16_t>(room);
+                    Score candidate = scoreMove(index, to);
+                    if (candidate < best) {
+                        best = candidate;
+                        best_move = to;
+                        found = true;
+                    }
+                }
+            }
+        };
+
+        tryTeacher(from.teacher);
+        // Замена преподавателя — только если своим преподавателем нарушение не снять
+        if (!found || best.violations > 0) {
+            for (int t : teachers_by_subject[from.subject])
+                if (t != from.teacher) tryTeacher(t);
+        }
+        if (found) apply(index, best_move);
+    }
+
+    // Следующий круг: нарушающие занятия и те, с кем они делят ячейку
+    void collectConflicts() {
+        const auto& lessons = schedule->lessons;
+        const OccupancyGrid& grid = evaluator.occupancy();
+        queue.clear();
+        for (size_t i = 0; i < lessons.size(); ++i)
+            if (violates(lessons[i])) queue.push_back(i);
+        if (queue.empty()) return;
+
+        // Ячейки нарушителей отмечаются по группе, преподавателю и аудитории
+        const size_t violators = queue.size();
+        for (size_t i = 0; i < lessons.size(); ++i) {
+            const Lesson& l = lessons[i];
+            if (movable[i] || violates(l)) continue;
+            bool shares = false;
+            for (size_t k = 0; k < violators && !shares; ++k) {
+                const Lesson& v = lessons[queue[k]];
+                shares = v.day == l.day && v.slot == l.slot &&
+                    (v.group == l.group || v.teacher == l.teacher || v.room == l.room);
+            }
+            if (shares && (grid.groupCount(l.group, l.day, l.slot) > 1 || grid.teacherCount(l.teacher, l.day, l.slot) > 1 ||
+                grid.roomCount(l.room, l.day, l.slot) > 1)) queue.push_back(i);
+        }
+    }
+
+    // Случайные переносы сдвинутых занятий в свободные ячейки; принимаются только улучшающие
+    void hillClimb(int steps, std::mt19937& gen) {
+        const Instance& inst = schedule->instance();
+        queue.clear();
+        for (size_t i = 0; i < movable.size(); ++i)
+            if (movable[i]) queue.push_back(i);
+        if (queue.empty()) return;
+        std::uniform_int_distribution<size_t> lesson_dist(0, queue.size() - 1);
+        std::uniform_int_distribution<> day_dist(0, inst.num_days - 1);
+        std::uniform_int_distribution<> slot_dist(0, inst.slots_per_day - 1);
+
+        Score current = score();
+        for (int step = 0; step < steps; ++step) {
+            size_t index = queue[lesson_dist(gen)];
+            const Lesson from = schedule->lessons[index];
+            int d = day_dist(gen);
+            int slot = slot_dist(gen);
+            if ((teacher_closed[from.teacher] >> d) & 1) continue;
+            const OccupancyGrid& grid = evaluator.occupancy();
+            int own = (from.day == d && from.slot == slot) ? 1 : 0;
+            if (grid.groupCount(from.group, d, slot) != own || grid.teacherCount(from.teacher, d, slot) != own) continue;
+            int room = chooseRoom(index, from, d, slot);
+            if (room < 0) continue;
+
+            Lesson to = from;
+            to.day = static_cast<uint8_t>(d);
+            to.slot = static_cast<uint8_t>(slot);
+            to.room = static_cast<uint16_t>(room);
+            if (blocked(to)) continue;
+            ++move_evaluations;
+            apply(index, to);
+            Score candidate = score();
+            if (candidate < current) current = candidate;
+            else undo(index, from);
+        }
+    }
+};
@@ -0,0 +1,189 @@
+#pragma once
+#include "genetic_algorithm.h"
+#include "thread_pool.h"
+#include "json.h"
+#include <string>
+#include <vector>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+
+// Сценарий «что если»: правки базового экземпляра, не меняющие его размеров.
+// Закрытая аудитория — вместимость 0: занятия в ней штрафуются как переполненные.
+struct Scenario {
+    std::string name;
+    std::vector<std::pair<int, int>> room_capacities;                   // (аудитория, вместимость)
+    std::vector<std::pair<int, int>> teacher_hours;                     // (преподаватель, часы за семестр)
+    std::vector<std::pair<int, std::vector<int>>> preferred_days;       // (преподаватель, дни); пустой список — без предпочтений
+
+    // Экземпляр сценария: копия базового с правками и пересчитанными таблицами
+    Instance apply(const Instance& base) const {
+        Instance inst = base;
+        for (const auto& c : room_capacities) {
+            check(c.first >= 0 && c.first < base.num_rooms, "несуществующая аудитория");
+            inst.room_capacities[c.first] = c.second;
+        }
+        for (const auto& h : teacher_hours) {
+            check(h.first >= 0 && h.first < base.num_teachers, "несуществующий преподаватель");
+            inst.teacher_semester_hours[h.first] = h.second;
+        }
+        for (const auto& p : preferred_days) {
+            check(p.first >= 0 && p.first < base.num_teachers, "несуществующий преподаватель");
+            inst.teacher_preferred_days[p.first] = p.second;
+        }
+        inst.finalize();
+        return inst;
+    }
+
+    // Файл сценариев — массив объектов, ресурсы указываются по именам:
+    // [{ "name": "закрыта 104", "rooms": { "104": 0 } },
+    //  { "name": "Петров +3 пары", "hours": { "Петров": 14 }, "preferred_days": { "Петров": [0, 2] } }]
+    static std::vector<Scenario> load(const std::string& path, const Instance& base) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("не удалось открыть файл сценариев: " + path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        Json root = Json::parse(buffer.str());
+
+        std::vector<Scenario> result;
+        for (const auto& item : root.array()) {
+            Scenario s;
+            s.name = item["name"].asString();
+            if (const Json* rooms = item.find("rooms")) {
+                for (const auto& kv : rooms->object())
+                    s.room_capacities.emplace_back(indexOf(base.rooms, kv.first, "аудитория"), kv.second.asInt());
+            }
+            if (const Json* hours = item.find("hours")) {
+                for (const auto& kv : hours->object())
+                    s.teacher_hours.emplace_back(indexOf(base.teachers, kv.first, "преподаватель"), kv.second.asInt());
+            }
+            if (const Json* days = item.find("preferred_days")) {
+                for (const auto& kv : days->object()) {
+                    std::vector<int> list;
+                    for (const auto& d : kv.second.array()) list.push_back(d.asInt());
+                    s.preferred_days.emplace_back(indexOf(base.teachers, kv.first, "преподаватель"), std::move(list));
+                }
+            }
+            result.push_back(std::move(s));
+        }
+        return result;
+    }
+
+private:
+    static void check(bool condition, const char* message) {
+        if (!condition) throw std::runtime_error(std::string("некорректный сценарий: ") + message);
+    }
+
+    static int indexOf(const std::vector<std::string>& names, const std::string& name, const char* what) {
+        for (size_t i = 0; i < names.size(); ++i)
+            if (names[i] == name) return static_cast<int>(i);
+        throw std::runtime_error(std::string("некорректный сценарий: ") + what + " не найден(а): " + name);
+    }
+};
+
+// Итог сценария для сравнительного отчёта
+struct ScenarioOutcome {
+    std::string name;
+    SolveResult result;
+    Schedule::Fitness minima{};         // Минимум каждой цели по фронту
+    double best_weighted = 0.0;         // Лучшая свёртка целей по фронту
+};
+
+// Пакетное решение сценариев. Сначала решается базовый экземпляр, затем
+// сценарии параллельно на пуле потоков, по одному однопоточному
+// GeneticAlgorithm на сценарий: на пакете это даёт больше прогонов в секунду,
+// чем распараллеливание каждого прогона по поколениям. Сценарии отличаются
+// от базы несколькими числами, поэтому начальная популяция каждого
+// затравливается расписаниями базового фронта и поиск начинается рядом с ответом.
+// Экземпляры сценариев — копии базового: их таблицы занимают O(групп +
+// преподавателей + аудиторий), что мало рядом с популяцией прогона.
+class BatchSolver {
+public:
+    // num_threads = 0 — по числу аппаратных потоков; base должен жить дольше решателя
+    BatchSolver(const Instance& base, std::vector<Scenario> scenarios, unsigned seed, size_t num_threads = Config::NUM_THREADS)
+        : base(base), scenarios(std::move(scenarios)), pool(num_threads), seed(seed) {
+        for (const Scenario& s : this->scenarios) instances.push_back(s.apply(base));
+    }
+
+    size_t size() const { return scenarios.size(); }
+    const Instance& instance(size_t i) const { return instances[i]; }
+
+    // Первый элемент результата — база, далее сценарии в порядке задания.
+    // options действуют на каждый прогон; on_progress вызывается из разных потоков.
+    std::vector<ScenarioOutcome> solve(const SolveOptions& options) {
+        std::seed_seq seq{ seed };
+        std::vector<unsigned> seeds(scenarios.size() + 1);
+        seq.generate(seeds.begin(), seeds.end());
+
+        std::vector<ScenarioOutcome> outcomes(scenarios.size() + 1);
+        outcomes[0].name = "база";
+        {
+            GeneticAlgorithm ga(base, seeds[0]);
+            ga.setConsoleOutput(false);
+            outcomes[0].result = ga.solve(options);
+        }
+        std::vector<Schedule> warm = spread(outcomes[0].result.front, Config::POPULATION_SIZE / 2);
+
+        pool.parallelFor(scenarios.size(), [&](size_t i) {
+            GeneticAlgorithm ga(instances[i], seeds[i + 1], 1);
+            ga.setConsoleOutput(false);
+            ga.seed(warm);
+            outcomes[i + 1].name = scenarios[i].name;
+            outcomes[i + 1].result = ga.solve(options);
+        });
+
+        for (ScenarioOutcome& o : outcomes) summarize(o);
+        return outcomes;
+    }
+
+    // Сравнительная таблица: итоги прогонов и изменение лучшей свёртки относительно базы
+    static void printReport(std::ostream& out, const std::vector<ScenarioOutcome>& outcomes) {
+        out << "сценарий                       остановка поколений       с  фронт   накладки     свёртка      к базе\n";
+        const double reference = outcomes.empty() ? 0.0 : outcomes[0].best_weighted;
+        for (const ScenarioOutcome& o : outcomes) {
+            pad(out, o.name, 28);
+            out << std::setw(12) << stopReasonName(o.result.reason) << std::setw(10) << o.result.generations
+                << std::setw(8) << std::fixed << std::setprecision(2) << o.result.seconds << std::setw(7) << o.result.front.size()
+                << std::setw(11) << std::setprecision(6) << o.minima[0] << std::setw(12) << o.best_weighted
+                << std::setw(12) << std::showpos << o.best_weighted - reference << std::noshowpos << '\n';
+        }
+        out.unsetf(std::ios::fixed);
+    }
+
+private:
+    const Instance& base;
+    std::vector<Scenario> scenarios;
+    std::vector<Instance> instances;
+    ThreadPool pool;
+    unsigned seed;
+
+    // std::setw считает байты, а имена сценариев обычно кириллические: ширина считается в символах UTF-8
+    static void pad(std::ostream& out, const std::string& text, size_t width) {
+        size_t chars = 0;
+        for (unsigned char c : text) chars += (c & 0xC0) != 0x80;
+        out << text << std::string(chars < width ? width - chars : 1, ' ');
+    }
+
+    // Не больше count расписаний фронта, взятых через равный шаг, чтобы затравка была разнообразной
+    static std::vector<Schedule> spread(const std::vector<Schedule>& front, size_t count) {
+        std::vector<Schedule> result;
+        if (front.empty() || count == 0) return result;
+        const size_t step = std::max<size_t>(1, front.size() / count);
+        for (size_t i = 0; i < front.size() && result.size() < count; i += step) result.push_back(front[i]);
+        return result;
+    }
+
+    static void summarize(ScenarioOutcome& o) {
+        o.minima.fill(std::numeric_limits<double>::infinity());
+        o.best_weighted = std::numeric_limits<double>::infinity();
+        for (const Schedule& s : o.result.front) {
+            const auto& f = s.fitness();
+            for (size_t k = 0; k < f.size(); ++k) o.minima[k] = std::min(o.minima[k], f[k]);
+            o.best_weighted = std::min(o.best_weighted, Schedule::weightedFitness(f));
+        }
+    }
+};
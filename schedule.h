@@ -1,40 +1,72 @@
 #pragma once
 #include "lesson.h"
 #include "config.h"
+#include "instance.h"
+#include "occupancy.h"
+#include "fitness_kernel.h"
+#include "shaped_fitness.h"
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 
+class IncrementalEvaluator;
+
 class Schedule {
+    friend class IncrementalEvaluator;
+
 public:
+    // Число целей, возвращаемых calculateFitness
+    static constexpr size_t NUM_OBJECTIVES = 7;
+    using Fitness = std::array<double, NUM_OBJECTIVES>;
+
     std::vector<Lesson> lessons;
 
+    explicit Schedule(const Instance& instance = Instance::defaultInstance()) : inst(&instance) {}
+
+    const Instance& instance() const { return *inst; }
+
+    // Кэшированный вектор целей: считается один раз после изменения генома.
+    // После прямой правки lessons нужно вызвать invalidateFitness().
+    const Fitness& fitness() const {
+        if (!fitness_valid) {
+            cached_fitness = calculateFitness();
+            fitness_valid = true;
+        }
+        return cached_fitness;
+    }
+
+    void invalidateFitness() { fitness_valid = false; }
+
+    // Кэш из ранее посчитанного значения (чтение снимка): гены не менялись
+    void restoreFitness(const Fitness& f) {
+        cached_fitness = f;
+        fitness_valid = true;
+    }
+
     void initialize(std::mt19937& gen) {
+        invalidateFitness();
         lessons.clear();
-        std::uniform_int_distribution<> room_dist(0, Config::NUM_ROOMS - 1);
-        std::uniform_int_distribution<> slot_dist(0, Config::SLOTS_PER_DAY - 1);
-        std::uniform_int_distribution<> day_dist(0, Config::NUM_DAYS - 1);
+        std::uniform_int_distribution<> room_dist(0, inst->num_rooms - 1);
+        std::uniform_int_distribution<> slot_dist(0, inst->slots_per_day - 1);
         std::uniform_int_distribution<> type_dist(0, 2);
 
-        // ИЗМЕНЕНО: 4 пары в день вместо 2
-        const int LESSONS_PER_DAY = Config::LESSONS_PER_GROUP_PER_DAY;
+        const int LESSONS_PER_DAY = inst->lessons_per_group_per_day;
+        lessons.reserve(inst->lessonsPerSchedule());
 
-        for (int g = 0; g < Config::NUM_GROUPS; ++g) {
-            for (int d = 0; d < Config::NUM_DAYS; ++d) {
+        for (int g = 0; g < inst->num_groups; ++g) {
+            for (int d = 0; d < inst->num_days; ++d) {
                 for (int i = 0; i < LESSONS_PER_DAY; ++i) {
                     Lesson l;
                     l.group = g;
                     l.day = d;
                     l.slot = slot_dist(gen);
-                    int room = room_dist(gen);
-                    l.room = room;
-                    l.room_capacity = Config::room_capacities[room];
-                    l.room_type = Config::room_types[room];
-                    l.type = (type_dist(gen) == 0 ? "Лекция" : (type_dist(gen) == 1 ? "Практика" : "Лабораторная"));
+                    l.room = room_dist(gen);
+                    l.type = (type_dist(gen) == 0 ? LessonType::Lecture : (type_dist(gen) == 1 ? LessonType::Practice : LessonType::Lab));
 
                     // Подбираем корректную пару преподаватель-предмет
-                    auto& pairs = Config::teacher_subject_pairs;
+                    auto& pairs = inst->teacher_subject_pairs;
                     std::uniform_int_distribution<> pair_dist(0, (int)pairs.size() - 1);
                     auto p = pairs[pair_dist(gen)];
                     l.teacher = p.first;
@@ -46,183 +78,161 @@ public:
         }
     }
 
-    std::vector<double> calculateFitness(int generation = 0, int maxGenerations = 1) const {
-        double hard_conflicts = 0.0;
-        double soft_gaps = 0.0;
-        double soft_balance = 0.0;
-        double capacity_conflicts = 0.0;
-        double type_conflicts = 0.0;
-        double soft_teacher_load = 0.0;
-        double soft_teacher_pref = 0.0;
+    Fitness calculateFitness(int generation = 0, int maxGenerations = 1) const {
+        // Экземпляр известной формы считается специализированной оценкой на стеке
+        Fitness shaped;
+        if (Config::SHAPED_FITNESS && KnownShapes::evaluate(*inst, lessons, shaped)) return shaped;
+        return generalFitness();
+    }
+
+    // Общая оценка для экземпляра любой формы, без ShapedFitness
+    Fitness generalFitness() const {
+        Fitness raw{};
+
+        // Индекс занятости строится за один проход; буфер переиспользуется между вызовами
+        thread_local OccupancyGrid grid;
+        grid.build(*inst, lessons);
 
         // === Жёсткие конфликты ===
-        for (size_t i = 0; i < lessons.size(); ++i) {
-            for (size_t j = i + 1; j < lessons.size(); ++j) {
-                const Lesson& a = lessons[i];
-                const Lesson& b = lessons[j];
-                if (a.day == b.day && a.slot == b.slot) {
-                    if (a.group == b.group) hard_conflicts++;
-                    if (a.teacher == b.teacher) hard_conflicts++;
-                    if (a.room == b.room) hard_conflicts++;
-                }
-            }
-        }
+        raw[0] = static_cast<double>(grid.hardConflicts());
 
         // === Окна ===
-        for (int g = 0; g < Config::NUM_GROUPS; ++g) {
-            for (int d = 0; d < Config::NUM_DAYS; ++d) {
-                std::vector<int> slots;
-                for (auto& l : lessons)
-                    if (l.group == g && l.day == d)
-                        slots.push_back(l.slot);
-                if (slots.size() > 1) {
-                    std::sort(slots.begin(), slots.end());
-                    for (size_t i = 1; i < slots.size(); ++i)
-                        soft_gaps += (slots[i] - slots[i - 1] - 1);
-                }
-            }
-        }
+        raw[1] = static_cast<double>(grid.gaps());
 
         // === Баланс нагрузки по группам ===
-        for (int g = 0; g < Config::NUM_GROUPS; ++g) {
-            std::vector<int> per_day(Config::NUM_DAYS, 0);
-            for (auto& l : lessons)
-                if (l.group == g)
-                    per_day[l.day]++;
-            double mean = 0.0;
-            for (auto v : per_day) mean += v;
-            mean /= Config::NUM_DAYS;
-            for (auto v : per_day)
-                soft_balance += std::pow(v - mean, 2);
-        }
+        raw[2] = grid.balance();
 
-        // === Нехватка мест ===
-        for (const auto& l : lessons) {
-            if (Config::group_sizes[l.group] > l.room_capacity) {
-                capacity_conflicts++;
-            }
-        }
+        // === Нехватка мест, неподходящий тип аудитории, предпочтения по дням ===
+        FitnessKernel::Counts counts = FitnessKernel::count(*inst, lessons.data(), lessons.size());
+        raw[3] = static_cast<double>(counts.capacity);
+        raw[4] = static_cast<double>(counts.type);
+        raw[6] = static_cast<double>(counts.preference);
 
-        // === Неподходящий тип аудитории ===
-        for (const auto& l : lessons) {
-            if ((l.type == "Лекция" && l.room_type != "Лекционная") ||
-                (l.type == "Практика" && l.room_type != "Компьютерная") ||
-                (l.type == "Лабораторная" && l.room_type != "Лабораторная")) {
-                type_conflicts++;
-            }
-        }
-
-        // === Нагрузка преподавателей (отклонение от часов) === ПОЛНОСТЬЮ ПЕРЕПИСАНО
-        std::vector<int> actual_load(Config::NUM_TEACHERS, 0);
+        // === Нагрузка преподавателей (отклонение от часов) ===
+        thread_local std::vector<int> actual_load;
+        actual_load.assign(inst->num_teachers, 0);
         for (const auto& l : lessons) actual_load[l.teacher]++;
 
-        static const std::vector<int> target_pairs = Config::get_target_pairs();
-        for (int t = 0; t < Config::NUM_TEACHERS; ++t) {
-            int diff = std::abs(actual_load[t] - target_pairs[t]);
-            soft_teacher_load += diff;
+        const auto& target = inst->target_pairs;
+        for (int t = 0; t < inst->num_teachers; ++t) {
+            raw[5] += std::abs(actual_load[t] - target[t]);
         }
 
-        // === Предпочтения по дням ===
-        for (const auto& l : lessons) {
-            const auto& pref = Config::teacher_preferred_days;
-            if (pref.count(l.teacher)) {
-                const auto& days = pref.at(l.teacher);
-                if (std::find(days.begin(), days.end(), l.day) == days.end()) {
-                    soft_teacher_pref++;
-                }
-            }
-        }
+        return normalizeFitness(raw, lessons.size());
+    }
+
+    // === Штрафы отдельного занятия (общие для полного и инкрементального расчёта) ===
+    bool capacityConflict(const Lesson& l) const {
+        return inst->group_sizes[l.group] > inst->room_capacities[l.room];
+    }
+
+    bool typeConflict(const Lesson& l) const {
+        return inst->room_types[l.room] != requiredRoomType(l.type);
+    }
+
+    bool preferenceConflict(const Lesson& l) const {
+        return !((inst->preferred_mask[l.teacher] >> l.day) & 1);
+    }
 
-        // === Нормировка ===
-        double max_conflicts = lessons.size() * (lessons.size() - 1) / 2.0;
-        double max_gaps = Config::NUM_GROUPS * Config::NUM_DAYS * (Config::SLOTS_PER_DAY - 1);
-        double max_balance = Config::NUM_GROUPS * (std::pow(Config::LESSONS_PER_GROUP_PER_DAY * Config::NUM_DAYS - Config::LESSONS_PER_GROUP_PER_DAY, 2) +
-            (Config::NUM_DAYS - 1) * std::pow(Config::LESSONS_PER_GROUP_PER_DAY, 2));
-        double max_capacity_conflicts = lessons.size();
-        double max_type_conflicts = lessons.size();
+    // Нормировка ненормированных сумм штрафов в диапазон [0, 1]
+    Fitness normalizeFitness(const Fitness& raw, size_t num_lessons) const {
+        const auto& target_pairs = inst->target_pairs;
+        double max_conflicts = num_lessons * (num_lessons - 1) / 2.0;
+        double max_gaps = inst->max_gaps;
+        double max_balance = inst->max_balance;
+        double max_capacity_conflicts = num_lessons;
+        double max_type_conflicts = num_lessons;
         double max_teacher_load = 0.0;
-        for (int t = 0; t < Config::NUM_TEACHERS; ++t) {
-            int diff = std::max(0, static_cast<int>(lessons.size()) - target_pairs[t]);
+        for (int t = 0; t < inst->num_teachers; ++t) {
+            int diff = std::max(0, static_cast<int>(num_lessons) - target_pairs[t]);
             max_teacher_load += diff;
         }
-        double max_teacher_pref = lessons.size();
-
-        hard_conflicts = max_conflicts > 0 ? hard_conflicts / max_conflicts : 0.0;
-        soft_gaps = max_gaps > 0 ? soft_gaps / max_gaps : 0.0;
-        soft_balance = max_balance > 0 ? soft_balance / max_balance : 0.0;
-        capacity_conflicts = max_capacity_conflicts > 0 ? capacity_conflicts / max_capacity_conflicts : 0.0;
-        type_conflicts = max_type_conflicts > 0 ? type_conflicts / max_type_conflicts : 0.0;
-        soft_teacher_load = max_teacher_load > 0 ? soft_teacher_load / max_teacher_load : 0.0;
-        soft_teacher_pref = max_teacher_pref > 0 ? soft_teacher_pref / max_teacher_pref : 0.0;
+        double max_teacher_pref = num_lessons;
 
         return {
-            hard_conflicts,
-            soft_gaps,
-            soft_balance,
-            capacity_conflicts,
-            type_conflicts,
-            soft_teacher_load,
-            soft_teacher_pref
+            max_conflicts > 0 ? raw[0] / max_conflicts : 0.0,
+            max_gaps > 0 ? raw[1] / max_gaps : 0.0,
+            max_balance > 0 ? raw[2] / max_balance : 0.0,
+            max_capacity_conflicts > 0 ? raw[3] / max_capacity_conflicts : 0.0,
+            max_type_conflicts > 0 ? raw[4] / max_type_conflicts : 0.0,
+            max_teacher_load > 0 ? raw[5] / max_teacher_load : 0.0,
+            max_teacher_pref > 0 ? raw[6] / max_teacher_pref : 0.0
         };
     }
 
+    // Свёртка целей с весами Config::weights: одно число для сравнения расписаний
+    static double weightedFitness(const Fitness& f) {
+        const auto& w = Config::weights;
+        return w.hard_conflict * f[0] + w.soft_gap * f[1] + w.soft_balance * f[2] + w.capacity_conflict * f[3] +
+            w.type_conflict * f[4] + w.teacher_load * f[5] + w.teacher_pref * f[6];
+    }
+
     void mutate(std::mt19937& gen) {
+        invalidateFitness();
         std::uniform_real_distribution<> prob(0, 1);
-        std::uniform_int_distribution<> room_dist(0, Config::NUM_ROOMS - 1);
-        std::uniform_int_distribution<> slot_dist(0, Config::SLOTS_PER_DAY - 1);
-        std::uniform_int_distribution<> day_dist(0, Config::NUM_DAYS - 1);
 
         // Текущая нагрузка
-        std::vector<int> current_load(Config::NUM_TEACHERS, 0);
+        thread_local std::vector<int> current_load;
+        current_load.assign(inst->num_teachers, 0);
         for (const auto& l : lessons) current_load[l.teacher]++;
 
-        static const std::vector<int> target_pairs = Config::get_target_pairs();
-
         for (auto& l : lessons) {
             if (prob(gen) < Config::MUTATION_RATE) {
-                int old_teacher = l.teacher;
-
-                // Умная мутация: 70% шанс выбрать недогруженного преподавателя
-                if (prob(gen) < 0.7) {
-                    std::vector<int> underloaded;
-                    for (int t = 0; t < Config::NUM_TEACHERS; ++t) {
-                        if (current_load[t] < target_pairs[t]) {
-                            underloaded.push_back(t);
-                        }
-                    }
-                    if (!underloaded.empty()) {
-                        std::uniform_int_distribution<> dist(0, underloaded.size() - 1);
-                        l.teacher = underloaded[dist(gen)];
-                    }
-                }
+                l = mutatedLesson(l, current_load, gen);
+            }
+        }
+    }
 
-                // Обновляем предмет под нового преподавателя
-                auto& pairs = Config::teacher_subject_pairs;
-                std::vector<int> valid_subjects;
-                for (const auto& p : pairs)
-                    if (p.first == l.teacher) valid_subjects.push_back(p.second);
-                if (!valid_subjects.empty()) {
-                    std::uniform_int_distribution<> dist(0, valid_subjects.size() - 1);
-                    l.subject = valid_subjects[dist(gen)];
+    // Случайный перенос занятия: новые преподаватель, предмет, день, слот и аудитория
+    Lesson mutatedLesson(const Lesson& from, const std::vector<int>& current_load, std::mt19937& gen) const {
+        std::uniform_real_distribution<> prob(0, 1);
+        std::uniform_int_distribution<> room_dist(0, inst->num_rooms - 1);
+        std::uniform_int_distribution<> slot_dist(0, inst->slots_per_day - 1);
+        std::uniform_int_distribution<> day_dist(0, inst->num_days - 1);
+        const auto& target_pairs = inst->target_pairs;
+        Lesson l = from;
+
+        // Ёмкость сразу по максимуму и при первом же вызове в потоке, а не по росту
+        thread_local std::vector<int> underloaded;
+        underloaded.reserve(inst->num_teachers);
+
+        // Умная мутация: 70% шанс выбрать недогруженного преподавателя
+        if (prob(gen) < 0.7) {
+            underloaded.clear();
+            for (int t = 0; t < inst->num_teachers; ++t) {
+                if (current_load[t] < target_pairs[t]) {
+                    underloaded.push_back(t);
                 }
+            }
+            if (!underloaded.empty()) {
+                std::uniform_int_distribution<> dist(0, underloaded.size() - 1);
+                l.teacher = underloaded[dist(gen)];
+            }
+        }
 
-                // День с учётом предпочтений
-                const auto& pref = Config::teacher_preferred_days;
-                if (pref.count(l.teacher) && prob(gen) < 0.7) {
-                    const auto& days = pref.at(l.teacher);
-                    std::uniform_int_distribution<> d(0, days.size() - 1);
-                    l.day = days[d(gen)];
-                }
-                else {
-                    l.day = day_dist(gen);
-                }
+        // Обновляем предмет под нового преподавателя
+        int valid_subjects = inst->subjectCount(l.teacher);
+        if (valid_subjects > 0) {
+            std::uniform_int_distribution<> dist(0, valid_subjects - 1);
+            l.subject = inst->subjectAt(l.teacher, dist(gen));
+        }
 
-                l.slot = slot_dist(gen);
-                int room = room_dist(gen);
-                l.room = room;
-                l.room_capacity = Config::room_capacities[room];
-                l.room_type = Config::room_types[room];
-            }
+        // День с учётом предпочтений
+        if (inst->hasPreferences(l.teacher) && prob(gen) < 0.7) {
+            std::uniform_int_distribution<> d(0, inst->preferredDayCount(l.teacher) - 1);
+            l.day = inst->preferredDayAt(l.teacher, d(gen));
         }
+        else {
+            l.day = day_dist(gen);
+        }
+
+        l.slot = slot_dist(gen);
+        l.room = room_dist(gen);
+        return l;
     }
+
+private:
+    const Instance* inst;
+    mutable Fitness cached_fitness{};
+    mutable bool fitness_valid = false;
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+#include "lesson.h"
+#include "instance.h"
+#include "occupancy.h"
+#include "fitness_kernel.h"
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+// Размеры экземпляра, известные при компиляции
+template <int Groups, int Teachers, int Rooms, int Days, int Slots, int PerDay>
+struct InstanceShape {
+    static constexpr int groups = Groups;
+    static constexpr int teachers = Teachers;
+    static constexpr int rooms = Rooms;
+    static constexpr int days = Days;
+    static constexpr int slots = Slots;
+    static constexpr int per_day = PerDay;
+    static constexpr int lessons = Groups * Days * PerDay;
+    static constexpr int cells = Days * Slots;
+
+    // Нормировочные константы: те же формулы, что в Instance::finalize и Schedule::normalizeFitness
+    static constexpr double max_conflicts = lessons * (lessons - 1) / 2.0;
+    static constexpr double max_gaps = Groups * Days * (Slots - 1);
+    static constexpr double max_balance = Groups * (static_cast<double>(PerDay * Days - PerDay) * (PerDay * Days - PerDay) +
+        (Days - 1) * static_cast<double>(PerDay) * PerDay);
+
+    static_assert(Days <= 64 && Slots <= 64, "маска слотов дня хранится в uint64_t");
+
+    static bool matches(const Instance& inst, size_t num_lessons) {
+        return inst.num_groups == Groups && inst.num_teachers == Teachers && inst.num_rooms == Rooms &&
+            inst.num_days == Days && inst.slots_per_day == Slots && inst.lessons_per_group_per_day == PerDay &&
+            num_lessons == static_cast<size_t>(lessons);
+    }
+};
+
+// Размеры встроенных тестовых данных Config (и instances/demo.json)
+using ConfigShape = InstanceShape<Config::NUM_GROUPS, Config::NUM_TEACHERS, Config::NUM_ROOMS, Config::NUM_DAYS,
+    Config::SLOTS_PER_DAY, Config::LESSONS_PER_GROUP_PER_DAY>;
+
+// Оценка расписания экземпляра известной формы. Индекс занятости — массивы
+// фиксированного размера на стеке, циклы по группам и дням имеют постоянные
+// границы и разворачиваются компилятором, нормировка — константы.
+// Результат совпадает с Schedule::calculateFitness до бита.
+template <class Shape>
+struct ShapedFitness {
+    using Fitness = std::array<double, 7>;
+
+    static Fitness evaluate(const Instance& inst, const Lesson* lessons) {
+        std::array<uint16_t, Shape::groups * Shape::cells> group_cells{};
+        std::array<uint16_t, Shape::teachers * Shape::cells> teacher_cells{};
+        std::array<uint16_t, Shape::rooms * Shape::cells> room_cells{};
+        std::array<uint64_t, Shape::groups * Shape::days> day_mask{};
+        std::array<uint16_t, Shape::groups * Shape::days> day_count{};
+        std::array<int, Shape::teachers> load{};
+
+        long long conflicts = 0;
+        for (int i = 0; i < Shape::lessons; ++i) {
+            const Lesson& l = lessons[i];
+            const int cell = l.day * Shape::slots + l.slot;
+            conflicts += group_cells[l.group * Shape::cells + cell]++;
+            conflicts += teacher_cells[l.teacher * Shape::cells + cell]++;
+            conflicts += room_cells[l.room * Shape::cells + cell]++;
+            day_mask[l.group * Shape::days + l.day] |= uint64_t(1) << l.slot;
+            day_count[l.group * Shape::days + l.day]++;
+            load[l.teacher]++;
+        }
+
+        Fitness raw{};
+        raw[0] = static_cast<double>(conflicts);
+
+        long long gaps = 0;
+        for (uint64_t mask : day_mask) gaps += Bits::gaps(mask);
+        raw[1] = static_cast<double>(gaps);
+
+        for (int g = 0; g < Shape::groups; ++g) {
+            const uint16_t* per_day = &day_count[g * Shape::days];
+            double mean = 0.0;
+            for (int d = 0; d < Shape::days; ++d) mean += per_day[d];
+            mean /= Shape::days;
+            for (int d = 0; d < Shape::days; ++d) {
+                double diff = per_day[d] - mean;
+                raw[2] += diff * diff;
+            }
+        }
+
+        FitnessKernel::Counts counts = FitnessKernel::countScalar(inst, lessons, Shape::lessons);
+        raw[3] = static_cast<double>(counts.capacity);
+        raw[4] = static_cast<double>(counts.type);
+        raw[6] = static_cast<double>(counts.preference);
+
+        double max_teacher_load = 0.0;
+        for (int t = 0; t < Shape::teachers; ++t) {
+            raw[5] += std::abs(load[t] - inst.target_pairs[t]);
+            max_teacher_load += std::max(0, Shape::lessons - inst.target_pairs[t]);
+        }
+
+        return {
+            Shape::max_conflicts > 0 ? raw[0] / Shape::max_conflicts : 0.0,
+            Shape::max_gaps > 0 ? raw[1] / Shape::max_gaps : 0.0,
+            Shape::max_balance > 0 ? raw[2] / Shape::max_balance : 0.0,
+            raw[3] / Shape::lessons,
+            raw[4] / Shape::lessons,
+            max_teacher_load > 0 ? raw[5] / max_teacher_load : 0.0,
+            raw[6] / Shape::lessons
+        };
+    }
+};
+
+// Оценка первой подходящей формы из списка; false — экземпляр ни одной не подходит
+template <class... Shapes>
+struct ShapeDispatch {
+    template <class Fitness>
+    static bool evaluate(const Instance&, const std::vector<Lesson>&, Fitness&) { return false; }
+};
+
+template <class Shape, class... Rest>
+struct ShapeDispatch<Shape, Rest...> {
+    template <class Fitness>
+    static bool evaluate(const Instance& inst, const std::vector<Lesson>& lessons, Fitness& out) {
+        if (Shape::matches(inst, lessons.size())) {
+            out = ShapedFitness<Shape>::evaluate(inst, lessons.data());
+            return true;
+        }
+        return ShapeDispatch<Rest...>::evaluate(inst, lessons, out);
+    }
+};
+
+// Формы, для которых собираются специализированные оценки; остальные экземпляры
+// считаются общим calculateFitness. Новая частая форма добавляется в этот список.
+using KnownShapes = ShapeDispatch<ConfigShape>;
@@ -0,0 +1,57 @@
+#pragma once
+#include "schedule.h"
+#include "pareto_archive.h"
+#include "telemetry.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Причина остановки GeneticAlgorithm::solve
+enum class StopReason : uint8_t { Generations, TimeLimit, EvaluationBudget, Stagnation, ConflictFree, Cancelled };
+
+inline const char* stopReasonName(StopReason r) {
+    switch (r) {
+    case StopReason::Generations: return "generations";
+    case StopReason::TimeLimit: return "time_limit";
+    case StopReason::EvaluationBudget: return "evaluation_budget";
+    case StopReason::Stagnation: return "stagnation";
+    case StopReason::ConflictFree: return "conflict_free";
+    default: return "cancelled";
+    }
+}
+
+// Состояние прогона, передаваемое обратному вызову после поколения
+struct SolveProgress {
+    int generation;
+    double seconds;
+    long long evaluations;
+    int stalled_generations;            // Поколений подряд без улучшения
+    const ParetoArchive& front;         // Текущий архив недоминируемых расписаний
+    const GenerationStats& stats;
+};
+
+// Условия остановки solve; проверяются между поколениями.
+// Нулевое значение ограничения означает, что оно не действует.
+struct SolveOptions {
+    double time_limit = 0.0;                    // Секунд с начала solve
+    long long max_evaluations = 0;              // Полных оценок расписаний
+    int max_generations = Config::MAX_GENERATIONS;
+    int stall_window = Config::STALL_WINDOW;    // Поколений без улучшения до остановки
+    double stall_tolerance = Config::STALL_TOLERANCE; // Минимальное относительное улучшение
+    bool stop_when_conflict_free = false;       // Остановиться на первом расписании без накладок
+    const std::atomic<bool>* cancel = nullptr;  // Флаг отмены, выставляемый другим потоком
+    std::function<void(const SolveProgress&)> on_progress;
+    int progress_interval = 1;                  // Вызывать on_progress каждые N поколений
+    bool resume = false;                        // Продолжить с текущего состояния вместо reset
+    std::string checkpoint_path;                // Файл снимка; пустой — не сохранять
+    int checkpoint_interval = Config::CHECKPOINT_INTERVAL; // Сохранять снимок каждые N поколений и в конце
+};
+
+struct SolveResult {
+    std::vector<Schedule> front;
+    StopReason reason = StopReason::Generations;
+    int generations = 0;
+    long long evaluations = 0;
+    double seconds = 0.0;
+};
@@ -0,0 +1,294 @@
+#pragma once
+#include "genetic_algorithm.h"
+#include "json.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <limits>
+
+// Долгоживущий сервис решения с протоколом строк JSON: один запрос — одна строка,
+// каждое событие — одна строка ответа. Загруженные экземпляры, их
+// GeneticAlgorithm с пулом потоков и последний фронт остаются в памяти между
+// запросами, поэтому повторное решение не тратит время на запуск и разбор задачи.
+//
+// Запросы (поле id необязательно и возвращается в ответах):
+//   {"op": "load", "instance": "кафедра", "path": "instances/demo.json", "seed": 1}
+//   {"op": "solve", "instance": "кафедра", "time": 30, "evaluations": 0, "generations": 0,
+//    "stall": 50, "progress": 10, "resume": false, "lessons": false}
+//   {"op": "cancel", "instance": "кафедра"}
+//   {"op": "front", "instance": "кафедра", "lessons": true}
+//   {"op": "unload", "instance": "кафедра"}
+//   {"op": "status"}
+// solve выполняется в своём потоке и отвечает событиями accepted, progress и result;
+// resume продолжает прошлый прогон этого экземпляра вместо нового начала,
+// generations и evaluations тогда считаются сверх уже сделанных.
+// Одновременно решается не больше Config::SERVICE_MAX_JOBS экземпляров, каждый
+// на своей доле ядер. Ошибка запроса — событие error с текстом.
+// Гены в ответе — массивы [группа, преподаватель, предмет, аудитория, день, пара, тип].
+class SolverService {
+public:
+    using Sink = std::function<void(const std::string&)>;
+
+    explicit SolverService(Sink sink) : sink(std::move(sink)) {}
+
+    SolverService(const SolverService&) = delete;
+    SolverService& operator=(const SolverService&) = delete;
+
+    ~SolverService() { shutdown(); }
+
+    // Обработать одну строку запроса; false — запрошено завершение (op = quit)
+    bool handle(const std::string& line) {
+        std::string id;
+        try {
+            Json request = Json::parse(line);
+            if (const Json* value = request.find("id")) id = value->asString();
+            const std::string& op = request["op"].asString();
+            if (op == "quit") return false;
+            if (op == "load") load(id, request);
+            else if (op == "solve") solve(id, request);
+            else if (op == "cancel") cancel(id, request);
+            else if (op == "front") front(id, request);
+            else if (op == "unload") unload(id, request);
+            else if (op == "status") status(id);
+            else throw std::runtime_error("неизвестная операция: " + op);
+        }
+        catch (const std::exception& e) {
+            emit(id, "error", "\"message\":" + quote(e.what()));
+        }
+        return true;
+    }
+
+    // Ошибка, не связанная с разобранным запросом (например, слишком длинная строка)
+    void reject(const std::string& message) { emit("", "error", "\"message\":" + quote(message)); }
+
+    // Дождаться завершения начатых прогонов
+    void wait() { joinWorkers(false); }
+
+    // Отменить все прогоны и дождаться их завершения
+    void shutdown() { joinWorkers(true); }
+
+private:
+    struct Entry {
+        Instance instance;
+        std::unique_ptr<GeneticAlgorithm> ga;
+        std::vector<Schedule> front;        // Результат последнего прогона
+        std::thread worker;
+        std::atomic<bool> cancel{ false };
+        std::atomic<bool> running{ false };
+    };
+
+    Sink sink;
+    std::mutex sink_mutex;
+    std::mutex entries_mutex;
+    std::map<std::string, std::unique_ptr<Entry>> entries;
+
+    // Потоки забираются под замком, а ждутся без него: в конце прогона поток сам берёт замок
+    void joinWorkers(bool cancel_running) {
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lock(entries_mutex);
+            for (auto& e : entries) {
+                if (cancel_running) e.second->cancel = true;
+                if (e.second->worker.joinable()) workers.push_back(std::move(e.second->worker));
+            }
+        }
+        for (auto& w : workers) w.join();
+    }
+
+    static std::string quote(const std::string& s) {
+        std::string out = "\"";
+        for (char c : s) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                }
+                else out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    static void writeArray(std::ostringstream& out, const Schedule::Fitness& f) {
+        out << '[';
+        for (size_t i = 0; i < f.size(); ++i) out << (i ? "," : "") << f[i];
+        out << ']';
+    }
+
+    static std::string frontJson(const std::vector<Schedule>& front, bool with_lessons) {
+        std::ostringstream out;
+        out.precision(9);
+        out << "\"front\":[";
+        for (size_t i = 0; i < front.size(); ++i) {
+            out << (i ? "," : "") << "{\"objectives\":";
+            writeArray(out, front[i].fitness());
+            if (with_lessons) {
+                out << ",\"lessons\":[";
+                const auto& lessons = front[i].lessons;
+                for (size_t k = 0; k < lessons.size(); ++k) {
+                    const Lesson& l = lessons[k];
+                    out << (k ? "," : "") << '[' << l.group << ',' << l.teacher << ',' << l.subject << ',' << l.room << ','
+                        << int(l.day) << ',' << int(l.slot) << ',' << int(l.type) << ']';
+                }
+                out << ']';
+            }
+            out << '}';
+        }
+        out << ']';
+        return out.str();
+    }
+
+    // Строка ответа; sink вызывается под замком, поэтому строки потоков не перемешиваются
+    void emit(const std::string& id, const char* event, const std::string& fields = "") {
+        std::string line = "{\"id\":" + quote(id) + ",\"event\":\"" + event + "\"";
+        if (!fields.empty()) line += "," + fields;
+        line += "}";
+        std::lock_guard<std::mutex> lock(sink_mutex);
+        sink(line);
+    }
+
+    static bool flag(const Json& request, const char* key) {
+        const Json* value = request.find(key);
+        return value && value->asBool();
+    }
+
+    Entry& entry(const Json& request) {
+        const std::string& name = request["instance"].asString();
+        auto it = entries.find(name);
+        if (it == entries.end()) throw std::runtime_error("экземпляр не загружен: " + name);
+        return *it->second;
+    }
+
+    size_t runningJobs() const {
+        size_t count = 0;
+        for (const auto& e : entries) count += e.second->running;
+        return count;
+    }
+
+    static size_t threadsPerJob() {
+        size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, hardware / Config::SERVICE_MAX_JOBS);
+    }
+
+    void load(const std::string& id, const Json& request) {
+        const std::string& name = request["instance"].asString();
+        auto e = std::make_unique<Entry>();
+        const Json* path = request.find("path");
+        e->instance = path ? Instance::load(path->asString()) : Instance::fromConfig();
+        unsigned seed = request.contains("seed") ? static_cast<unsigned>(request["seed"].asInteger(0, std::numeric_limits<unsigned>::max())) : std::random_device{}();
+        e->ga = std::make_unique<GeneticAlgorithm>(e->instance, seed, threadsPerJob());
+        e->ga->setConsoleOutput(false);
+
+        std::lock_guard<std::mutex> lock(entries_mutex);
+        auto it = entries.find(name);
+        if (it != entries.end() && it->second->running) throw std::runtime_error("экземпляр занят: " + name);
+        if (it != entries.end() && it->second->worker.joinable()) it->second->worker.join();
+        entries[name] = std::move(e);
+        emit(id, "loaded", "\"instance\":" + quote(name) + ",\"lessons\":" + std::to_string(entries[name]->instance.lessonsPerSchedule()));
+    }
+
+    void solve(const std::string& id, const Json& request) {
+        std::lock_guard<std::mutex> lock(entries_mutex);
+        Entry& e = entry(request);
+        if (e.running) throw std::runtime_error("экземпляр уже решается");
+        if (runningJobs() >= static_cast<size_t>(Config::SERVICE_MAX_JOBS)) throw std::runtime_error("все слоты решения заняты");
+        if (e.worker.joinable()) e.worker.join();
+
+        SolveOptions options;
+        if (const Json* v = request.find("time")) options.time_limit = v->asNumber();
+        if (const Json* v = request.find("evaluations")) options.max_evaluations = v->asInteger(0, std::numeric_limits<long long>::max());
+        if (const Json* v = request.find("generations")) options.max_generations = v->asInt();
+        else if (options.time_limit > 0 || options.max_evaluations > 0) options.max_generations = 0;
+        if (const Json* v = request.find("stall")) options.stall_window = v->asInt();
+        options.resume = flag(request, "resume");
+        // Пределы GeneticAlgorithm считаются от начала поиска; при resume запрос задаёт их приращение
+        if (options.resume) {
+            if (options.max_generations > 0) options.max_generations += e.ga->generation();
+            if (options.max_evaluations > 0) options.max_evaluations += e.ga->evaluations();
+        }
+        options.stop_when_conflict_free = flag(request, "conflict_free");
+        options.cancel = &e.cancel;
+        options.progress_interval = request.contains("progress") ? request["progress"].asInt() : 0;
+        options.on_progress = [this, id](const SolveProgress& p) {
+            std::ostringstream out;
+            out.precision(9);
+            out << "\"generation\":" << p.generation << ",\"seconds\":" << p.seconds << ",\"evaluations\":" << p.evaluations
+                << ",\"archive\":" << p.front.size() << ",\"best\":";
+            writeArray(out, p.stats.best);
+            emit(id, "progress", out.str());
+        };
+        const bool with_lessons = flag(request, "lessons");
+
+        e.cancel = false;
+        e.running = true;
+        emit(id, "accepted");
+        e.worker = std::thread([this, &e, id, options, with_lessons] {
+            try {
+                SolveResult result = e.ga->solve(options);
+                std::ostringstream out;
+                out << "\"reason\":\"" << stopReasonName(result.reason) << "\",\"generations\":" << result.generations
+                    << ",\"evaluations\":" << result.evaluations << ",\"seconds\":" << result.seconds << ",";
+                std::string fields = out.str() + frontJson(result.front, with_lessons);
+                {
+                    std::lock_guard<std::mutex> lock(entries_mutex);
+                    e.front = std::move(result.front);
+                }
+                emit(id, "result", fields);
+            }
+            catch (const std::exception& ex) {
+                emit(id, "error", "\"message\":" + quote(ex.what()));
+            }
+            e.running = false;
+        });
+    }
+
+    void cancel(const std::string& id, const Json& request) {
+        std::lock_guard<std::mutex> lock(entries_mutex);
+        Entry& e = entry(request);
+        e.cancel = true;
+        emit(id, "cancelling", "\"running\":" + std::string(e.running ? "true" : "false"));
+    }
+
+    void front(const std::string& id, const Json& request) {
+        std::lock_guard<std::mutex> lock(entries_mutex);
+        Entry& e = entry(request);
+        emit(id, "front", frontJson(e.front, flag(request, "lessons")));
+    }
+
+    void unload(const std::string& id, const Json& request) {
+        std::lock_guard<std::mutex> lock(entries_mutex);
+        Entry& e = entry(request);
+        if (e.running) throw std::runtime_error("экземпляр решается, сначала cancel");
+        if (e.worker.joinable()) e.worker.join();
+        entries.erase(request["instance"].asString());
+        emit(id, "unloaded");
+    }
+
+    void status(const std::string& id) {
+        std::lock_guard<std::mutex> lock(entries_mutex);
+        std::string list;
+        for (const auto& e : entries) {
+            if (!list.empty()) list += ",";
+            // Счётчик поколений работающего прогона меняет его поток, поэтому он читается только в простое
+            list += "{\"instance\":" + quote(e.first) + ",\"running\":" + (e.second->running ? "true" : "false");
+            if (!e.second->running) list += ",\"generation\":" + std::to_string(e.second->ga->generation());
+            list += ",\"front\":" + std::to_string(e.second->front.size()) + "}";
+        }
+        emit(id, "status", "\"instances\":[" + list + "]");
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include "schedule.h"
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+// Фазы поколения, для которых считается время
+enum class Phase : uint8_t { Selection, Crossover, Mutation, Repair, Evaluation, Archive, Sorting, Crowding };
+constexpr size_t NUM_PHASES = 8;
+
+inline const char* phaseName(Phase p) {
+    switch (p) {
+    case Phase::Selection: return "selection";
+    case Phase::Crossover: return "crossover";
+    case Phase::Mutation: return "mutation";
+    case Phase::Repair: return "repair";
+    case Phase::Evaluation: return "evaluation";
+    case Phase::Archive: return "archive";
+    case Phase::Sorting: return "sorting";
+    default: return "crowding";
+    }
+}
+
+// Время по фазам. Параллельные фазы суммируются по потокам (процессорное время),
+// поэтому сумма может превышать длительность поколения.
+struct PhaseTimes {
+    using Clock = std::chrono::steady_clock;
+    std::array<double, NUM_PHASES> seconds{};
+
+    void clear() { seconds.fill(0.0); }
+    double& operator[](Phase p) { return seconds[static_cast<size_t>(p)]; }
+    double operator[](Phase p) const { return seconds[static_cast<size_t>(p)]; }
+
+    // Записать время с since до текущего момента в фазу p и вернуть текущий момент
+    Clock::time_point lap(Phase p, Clock::time_point since) {
+        Clock::time_point now = Clock::now();
+        (*this)[p] += std::chrono::duration<double>(now - since).count();
+        return now;
+    }
+
+    PhaseTimes& operator+=(const PhaseTimes& o) {
+        for (size_t i = 0; i < NUM_PHASES; ++i) seconds[i] += o.seconds[i];
+        return *this;
+    }
+};
+
+// Счётчики и сводка целей одного поколения
+struct GenerationStats {
+    int generation = 0;
+    double seconds = 0.0;                   // Длительность поколения
+    PhaseTimes phases;
+    long long evaluations = 0;              // Полных оценок расписаний
+    long long move_evaluations = 0;         // Инкрементальных оценок ходов (ремонт, локальный поиск)
+    unsigned long long allocations = 0;     // Выделений памяти, если включён AllocCounter
+    size_t front_size = 0;
+    Schedule::Fitness best{};               // Минимум каждой цели по популяции
+    Schedule::Fitness median{};
+};
+
+// Трасса прогона в формате JSON Lines: одна строка-объект на поколение.
+// Запись буферизуется потоком файла; сброс на диск — при закрытии.
+class TraceWriter {
+public:
+    void open(const std::string& path) {
+        out.open(path, std::ios::out | std::ios::trunc);
+        if (!out) throw std::runtime_error("не удалось открыть файл трассы: " + path);
+        out.precision(9);
+    }
+
+    bool isOpen() const { return out.is_open(); }
+
+    void close() {
+        if (out.is_open()) out.close();
+    }
+
+    void write(const GenerationStats& s) {
+        if (!out.is_open()) return;
+        out << "{\"generation\":" << s.generation << ",\"seconds\":" << s.seconds << ",\"phases\":{";
+        for (size_t i = 0; i < NUM_PHASES; ++i) {
+            out << (i ? "," : "") << '"' << phaseName(static_cast<Phase>(i)) << "\":" << s.phases.seconds[i];
+        }
+        out << "},\"evaluations\":" << s.evaluations << ",\"move_evaluations\":" << s.move_evaluations
+            << ",\"allocations\":" << s.allocations << ",\"front_size\":" << s.front_size << ",\"best\":";
+        writeArray(s.best);
+        out << ",\"median\":";
+        writeArray(s.median);
+        out << "}\n";
+    }
+
+private:
+    std::ofstream out;
+
+    void writeArray(const Schedule::Fitness& f) {
+        out << '[';
+        for (size_t i = 0; i < f.size(); ++i) out << (i ? "," : "") << f[i];
+        out << ']';
+    }
+};
@@ -0,0 +1,63 @@
+// Проверка отсутствия выделений памяти в установившемся поколении GeneticAlgorithm::evolve.
+// Сборка: g++ -std=c++17 -O2 -pthread -I. tests/alloc_check.cpp -o alloc_check
+// (PARAPLAN_COUNT_ALLOCATIONS задаётся в самом файле, как в bench/benchmark.cpp).
+// После прогрева поколение может выделить память только под гены новых слотов
+// внешнего архива: он растёт до Config::ARCHIVE_SIZE + 1 слота и дальше
+// переиспользует их. Любое другое выделение — регрессия двойной буферизации;
+// код возврата тогда не нулевой.
+#define PARAPLAN_COUNT_ALLOCATIONS
+#include "alloc_counter.h"
+#include "genetic_algorithm.h"
+#include "instance_generator.h"
+#include <cstdio>
+
+namespace {
+    const int WARMUP = 10;          // Поколений на заполнение буферов популяции и потоков
+    const int GENERATIONS = 100;
+
+    int failures = 0;
+
+    void check(const Instance& inst, const char* name, size_t threads, Survival survival) {
+        // Выделений на копию расписания в новый слот архива
+        Schedule probe(inst);
+        probe.lessons.assign(inst.lessonsPerSchedule(), Lesson{});
+        unsigned long long before = AllocCounter::count();
+        { Schedule copy = probe; }
+        const unsigned long long per_slot = AllocCounter::count() - before;
+
+        GeneticAlgorithm ga(inst, 7, threads);
+        ga.setConsoleOutput(false);
+        ga.setSurvival(survival);
+        ga.reset();
+        for (int g = 0; g < WARMUP; ++g) ga.evolve();
+
+        unsigned long long unexplained = 0;
+        int quiet = 0;
+        for (int g = 0; g < GENERATIONS; ++g) {
+            size_t slots = ga.archive().slots();
+            before = AllocCounter::count();
+            ga.evolve();
+            unsigned long long allocations = AllocCounter::count() - before;
+            unsigned long long expected = (ga.archive().slots() - slots) * per_slot;
+            if (allocations != expected) unexplained += allocations > expected ? allocations - expected : expected - allocations;
+            quiet += allocations == 0;
+        }
+        std::printf("%-10s %2zu потоков %-13s поколений без выделений %3d из %d, лишних выделений %llu\n", name, threads,
+            survivalName(survival), quiet, GENERATIONS, unexplained);
+        if (unexplained) ++failures;
+    }
+}
+
+int main() {
+    const Instance instances[] = { Instance::fromConfig(), generateInstance(10, 2), generateInstance(100, 3) };
+    const char* names[] = { "Config", "10 групп", "100 групп" };
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t threads : { 1, 4 })
+            for (Survival survival : { Survival::Generational, Survival::MuPlusLambda, Survival::SteadyState })
+                check(instances[i], names[i], threads, survival);
+    if (failures) {
+        std::fprintf(stderr, "выделения памяти в установившихся поколениях: %d конфигураций\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Проверка IncrementalEvaluator: после каждого хода (apply, undo, moveDelta, commit)
+// цели должны совпадать с полным пересчётом Schedule::calculateFitness.
+// Сборка: g++ -std=c++17 -O2 -pthread -I. tests/incremental_check.cpp -o incremental_check
+// Код возврата не нулевой, если найдено расхождение.
+#include "incremental_evaluator.h"
+#include "instance_generator.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+    const int STEPS = 20000;
+    // Инкрементальный баланс считается как sum c^2 - n^2 / D, поэтому сравнение с допуском
+    const double TOLERANCE = 1e-9;
+
+    int failures = 0;
+
+    bool same(const Schedule::Fitness& a, const Schedule::Fitness& b) {
+        for (size_t k = 0; k < a.size(); ++k)
+            if (std::abs(a[k] - b[k]) > TOLERANCE * std::max(1.0, std::abs(b[k]))) return false;
+        return true;
+    }
+
+    void expect(bool condition, const char* what, const char* instance, int step) {
+        if (condition) return;
+        if (++failures <= 10) std::fprintf(stderr, "%s, шаг %d: %s\n", instance, step, what);
+    }
+
+    // Ход: обычно как у мутации, иногда в произвольную клетку и аудиторию, чтобы появлялись накладки
+    Lesson randomMove(const Schedule& s, const IncrementalEvaluator& eval, size_t index, std::mt19937& gen) {
+        const Instance& inst = s.instance();
+        if (gen() % 4) return s.mutatedLesson(s.lessons[index], eval.teacherLoads(), gen);
+        Lesson l = s.lessons[index];
+        l.day = static_cast<uint8_t>(gen() % inst.num_days);
+        l.slot = static_cast<uint8_t>(gen() % inst.slots_per_day);
+        l.room = static_cast<uint16_t>(gen() % inst.num_rooms);
+        return l;
+    }
+
+    void check(const Instance& inst, const char* name, unsigned seed) {
+        std::mt19937 gen(seed);
+        Schedule s(inst);
+        s.initialize(gen);
+        IncrementalEvaluator eval(s);
+        expect(same(eval.fitness(), s.calculateFitness()), "начальное состояние", name, 0);
+
+        std::uniform_int_distribution<size_t> pick(0, s.lessons.size() - 1);
+        for (int step = 1; step <= STEPS; ++step) {
+            size_t index = pick(gen);
+            Lesson to = randomMove(s, eval, index, gen);
+            Schedule::Fitness before = eval.fitness();
+
+            Schedule::Fitness delta = eval.moveDelta(index, to);
+            expect(same(eval.fitness(), before), "moveDelta изменил состояние", name, step);
+
+            eval.apply(index, to);
+            Schedule::Fitness full = s.calculateFitness();
+            expect(same(eval.fitness(), full), "apply расходится с calculateFitness", name, step);
+            Schedule::Fitness predicted = before;
+            for (size_t k = 0; k < predicted.size(); ++k) predicted[k] += delta[k];
+            expect(same(predicted, full), "moveDelta расходится с применённым ходом", name, step);
+
+            switch (gen() % 3) {
+            case 0:
+                eval.undo();
+                expect(same(eval.fitness(), s.calculateFitness()), "undo расходится с calculateFitness", name, step);
+                expect(same(eval.fitness(), before), "undo не вернул прежние цели", name, step);
+                break;
+            case 1:
+                eval.commit();
+                expect(same(s.fitness(), s.calculateFitness()), "commit записал неверный кэш целей", name, step);
+                break;
+            default:
+                break; // ход остаётся в журнале, следующие ложатся поверх
+            }
+        }
+        eval.commit();
+        expect(same(s.fitness(), s.calculateFitness()), "итоговый commit", name, STEPS);
+    }
+}
+
+int main() {
+    check(Instance::fromConfig(), "Config", 1);
+    check(generateInstance(10, 2), "10 групп", 2);
+    check(generateInstance(100, 3), "100 групп", 3);
+    if (failures) {
+        std::fprintf(stderr, "расхождений: %d\n", failures);
+        return 1;
+    }
+    std::printf("IncrementalEvaluator совпадает с calculateFitness\n");
+    return 0;
+}
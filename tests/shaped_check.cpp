@@ -0,0 +1,77 @@
+// Проверка ShapedFitness: на экземпляре формы ConfigShape оценка фиксированной
+// формы должна совпадать с общей Schedule::generalFitness до бита.
+// Сборка: g++ -std=c++17 -O2 -pthread -I. tests/shaped_check.cpp -o shaped_check
+// Код возврата не нулевой, если найдено расхождение.
+#include "schedule.h"
+#include "shaped_fitness.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace {
+    const int SCHEDULES = 2000;
+
+    int failures = 0;
+
+    void compare(const Schedule& s, const char* what, int round) {
+        const Schedule::Fitness shaped = ShapedFitness<ConfigShape>::evaluate(s.instance(), s.lessons.data());
+        const Schedule::Fitness general = s.generalFitness();
+        if (std::memcmp(shaped.data(), general.data(), sizeof(shaped)) == 0) return;
+        if (++failures <= 10) {
+            std::fprintf(stderr, "%s, расписание %d:", what, round);
+            for (size_t k = 0; k < shaped.size(); ++k)
+                if (std::memcmp(&shaped[k], &general[k], sizeof(double)) != 0)
+                    std::fprintf(stderr, " цель %zu: %.17g вместо %.17g", k, shaped[k], general[k]);
+            std::fprintf(stderr, "\n");
+        }
+    }
+
+    // Произвольные клетки, аудитории и преподаватели: накладки, окна и нарушения всех видов
+    void scramble(Schedule& s, std::mt19937& gen, int moves) {
+        const Instance& inst = s.instance();
+        std::uniform_int_distribution<size_t> pick(0, s.lessons.size() - 1);
+        for (int m = 0; m < moves; ++m) {
+            Lesson& l = s.lessons[pick(gen)];
+            l.day = static_cast<uint8_t>(gen() % inst.num_days);
+            l.slot = static_cast<uint8_t>(gen() % inst.slots_per_day);
+            l.room = static_cast<uint16_t>(gen() % inst.num_rooms);
+            if (gen() % 2) l.teacher = static_cast<uint16_t>(gen() % inst.num_teachers);
+            l.type = static_cast<LessonType>(gen() % 3);
+        }
+    }
+}
+
+int main() {
+    const Instance inst = Instance::fromConfig();
+    std::mt19937 gen(1);
+    Schedule s(inst);
+    s.initialize(gen);
+    if (!ConfigShape::matches(inst, s.lessons.size())) {
+        std::fprintf(stderr, "экземпляр Config не совпадает с ConfigShape\n");
+        return 1;
+    }
+
+    for (int round = 0; round < SCHEDULES; ++round) {
+        s.initialize(gen);
+        compare(s, "после initialize", round);
+        s.mutate(gen);
+        compare(s, "после mutate", round);
+        scramble(s, gen, 1 + static_cast<int>(gen() % s.lessons.size()));
+        compare(s, "после случайных переносов", round);
+    }
+
+    // Крайний случай: все занятия в одной клетке и одной аудитории
+    for (Lesson& l : s.lessons) {
+        l.day = 0;
+        l.slot = 0;
+        l.room = 0;
+    }
+    compare(s, "все занятия в одной клетке", SCHEDULES);
+
+    if (failures) {
+        std::fprintf(stderr, "расхождений: %d\n", failures);
+        return 1;
+    }
+    std::printf("ShapedFitness<ConfigShape> совпадает с generalFitness\n");
+    return 0;
+}
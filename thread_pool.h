@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <exception>
+
+// Пул рабочих потоков с параллельным циклом по номерам задач.
+// Вызывающий поток тоже выполняет задачи, поэтому пул размера 1 работает без потоков.
+// Задача передаётся без std::function, так что запуск цикла не выделяет память.
+// Исключение задачи останавливает выдачу оставшихся задач и после ожидания
+// всех потоков пробрасывается из parallelFor в вызывающий поток (первое из них).
+// Вложенные вызовы parallelFor на одном пуле не поддерживаются.
+class ThreadPool {
+public:
+    // threads = 0 — по числу аппаратных потоков
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 1; i < threads; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    // Выполнить fn(task) для task из [0, count) и дождаться завершения всех задач
+    template <class F>
+    void parallelFor(size_t count, F&& fn) {
+        if (count == 0) return;
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> submit(submit_mutex); // один цикл на пуле за раз
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &invoke<std::remove_reference_t<F>>;
+            job_context = &fn;
+            job_count = count;
+            next_task.store(0);
+            busy_workers = workers.size();
+            error = nullptr;
+            ++job_id;
+        }
+        wake.notify_all();
+        drain();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return busy_workers == 0; });
+        if (error) {
+            std::exception_ptr e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex submit_mutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool stopping = false;
+
+    // Текущий цикл
+    void (*job)(void*, size_t) = nullptr;
+    void* job_context = nullptr;
+    size_t job_count = 0;
+    size_t job_id = 0;
+    size_t busy_workers = 0;
+    std::atomic<size_t> next_task{ 0 };
+    std::exception_ptr error;       // Первое исключение задач текущего цикла
+
+    template <class F>
+    static void invoke(void* context, size_t task) {
+        (*static_cast<F*>(context))(task);
+    }
+
+    // Исключение не выпускается из потока: fn должна жить, пока её выполняют остальные потоки
+    void drain() {
+        try {
+            for (size_t task = next_task.fetch_add(1); task < job_count; task = next_task.fetch_add(1)) {
+                job(job_context, task);
+            }
+        }
+        catch (...) {
+            next_task.store(job_count);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+    }
+
+    void workerLoop() {
+        size_t seen_job = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || job_id != seen_job; });
+                if (stopping) return;
+                seen_job = job_id;
+            }
+            drain();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--busy_workers == 0) finished.notify_one();
+            }
+        }
+    }
+};